@@ -22,8 +22,13 @@ void TriBFTApp::initialize(int stage) {
         blockInterval_ = par("blockInterval");
         batchSize_ = par("batchSize");
         consensusTimeout_ = par("consensusTimeout");
+        pipelineDepth_ = par("pipelineDepth");
+        committedBlockWindow_ = par("committedBlockWindow");
+        blockLogPrefix_ = par("blockLogPrefix").stdstringValue();
         vrmEnabled_ = par("vrmEnabled");
         initialReputation_ = par("initialReputation");
+        sharedReputation_ = par("sharedReputation").boolValue();
+        reputationWeightLambda_ = par("reputationWeightLambda");
         
         // 🆕 读取自动交易生成参数
         autoGenerateTx_ = par("autoGenerateTx").boolValue();
@@ -33,6 +38,26 @@ void TriBFTApp::initialize(int stage) {
         enableMultiHop_ = par("enableMultiHop").boolValue();
         maxHops_ = par("maxHops");
         
+        // Shard handoff parameters
+        incrementalHandoff_ = par("incrementalHandoff").boolValue();
+        handoffHysteresis_ = par("handoffHysteresis").doubleValue();
+        
+        // Duplicate suppression parameters
+        dedupWindow_ = par("dedupWindow");
+        dedupFalsePositiveRate_ = par("dedupFalsePositiveRate").doubleValue();
+        dedupMaxBytes_ = par("dedupMaxBytes").intValue();
+        seenTxIds_.configure(dedupWindow_, dedupFalsePositiveRate_, dedupMaxBytes_);
+        
+        // Catch-up parameters
+        catchUpHeaderBatch_ = par("catchUpHeaderBatch");
+        catchUpBodyBatch_ = par("catchUpBodyBatch");
+        catchUpMaxInFlight_ = par("catchUpMaxInFlight");
+        catchUpTimeout_ = par("catchUpTimeout");
+        catchUpMaxAttempts_ = par("catchUpMaxAttempts");
+        catchUpPeerTimeout_ = par("catchUpPeerTimeout");
+        catchUpFetchBodies_ = par("catchUpFetchBodies").boolValue();
+        catchUpCheckpoints_ = par("catchUpCheckpoints").boolValue();
+        
         std::cout << "[INIT] " << getParentModule()->getFullName() << " stage=" << stage << " params read" << std::endl;
         std::cout << "[TX-GEN] autoGenerateTx=" << autoGenerateTx_ << " interval=" << txGenerationInterval_ << std::endl;
         std::cout << "[MULTI-HOP] enabled=" << enableMultiHop_ << " maxHops=" << maxHops_ << std::endl;
@@ -43,9 +68,15 @@ void TriBFTApp::initialize(int stage) {
         reputationSignal_ = registerSignal("reputation");
         throughputSignal_ = registerSignal("throughput");
         shardSizeSignal_ = registerSignal("shardSize");
+        catchUpTimeSignal_ = registerSignal("catchUpTime");
+        catchUpBlocksSignal_ = registerSignal("catchUpBlocks");
+        catchUpRetriesSignal_ = registerSignal("catchUpRetries");
+        catchUpFailedSignal_ = registerSignal("catchUpFailed");
         
         // Initialize state
         nodeID_ = getNodeID();
+        nodeIndex_ = NodeRegistry::getGlobalInstance().intern(nodeID_);
+        proposalIDs_ = std::make_shared<IdGenerator>(nodeIndex_);
         currentShardID_ = -1;
         isLeaderNode_ = false;
         isInitialized_ = false;
@@ -59,8 +90,8 @@ void TriBFTApp::initialize(int stage) {
         // Create timers
         consensusTimer_ = new cMessage("consensusTimer");
         shardMaintenanceTimer_ = new cMessage("shardMaintenanceTimer");
-        reputationDecayTimer_ = new cMessage("reputationDecayTimer");
         heartbeatTimer_ = new cMessage("heartbeatTimer");
+        syncTimer_ = new cMessage("syncTimer");
         txGenerationTimer_ = new cMessage("txGenerationTimer");  // 🆕 交易生成定时?        
         EV_INFO << "[TriBFT] Node " << nodeID_ << " initialized (stage 0)" << endl;
     }
@@ -72,6 +103,7 @@ void TriBFTApp::initialize(int stage) {
         initializeConsensus();
         std::cout << "[INIT] " << getParentModule()->getFullName() << " stage=" << stage << " after initializeConsensus" << std::endl;
         initializeReputation();
+        initializeSync();
         std::cout << "[INIT] " << getParentModule()->getFullName() << " stage=" << stage << " after initializeReputation" << std::endl;
         initializeTimers();
         std::cout << "[INIT] " << getParentModule()->getFullName() << " stage=" << stage << " after initializeTimers" << std::endl;
@@ -90,12 +122,15 @@ void TriBFTApp::finish() {
     // Cancel timers
     cancelAndDelete(consensusTimer_);
     cancelAndDelete(shardMaintenanceTimer_);
-    cancelAndDelete(reputationDecayTimer_);
     cancelAndDelete(heartbeatTimer_);
+    cancelAndDelete(syncTimer_);
     cancelAndDelete(txGenerationTimer_);  // 🆕 清理交易生成定时?    
     // Record final statistics
     recordStatistics();
     
+    // Shard logs are shared by all nodes: the first finish() closes them, later calls are no-ops
+    BlockLog::closeAll();
+    
     EV_INFO << "[TriBFT] Node " << nodeID_ << " finished" << endl;
 }
 
@@ -115,6 +150,7 @@ void TriBFTApp::initializeShard() {
             Constants::MIN_SHARD_SIZE,
             Constants::MAX_SHARD_SIZE
         );
+        shardManager_->setHandoffPolicy(incrementalHandoff_, handoffHysteresis_);
         initialized = true;
         EV_INFO << "🌍 [GLOBAL SHARD MANAGER] Initialized:" << endl;
         EV_INFO << "  - Radius: " << Constants::REGIONAL_SHARD_RADIUS << "m" << endl;
@@ -141,6 +177,9 @@ void TriBFTApp::initializeShard() {
 void TriBFTApp::initializeConsensus() {
     consensusEngine_ = std::make_unique<HotStuffEngine>();
     consensusEngine_->initialize(nodeID_, currentShardID_);
+    consensusEngine_->setProposalIdGenerator(proposalIDs_);
+    consensusEngine_->setPipelineDepth(pipelineDepth_);
+    consensusEngine_->setCommittedBlockLog(blockLogPrefix_, committedBlockWindow_);
     
     // Set callbacks
     consensusEngine_->setProposalCallback([this](const ConsensusProposal& proposal) {
@@ -151,18 +190,23 @@ void TriBFTApp::initializeConsensus() {
         this->onVoteGenerated(vote);
     });
     
-    consensusEngine_->setCommitCallback([this](const Block& block) {
-        this->onBlockCommitted(block);
+    consensusEngine_->setCommitCallback([this](const Block& block, const QuorumCertificate& qc) {
+        this->onBlockCommitted(block, qc);
     });
     
     consensusEngine_->setLogCallback([this](const std::string& msg) {
         this->onConsensusLog(msg);
     });
     
-    consensusEngine_->setPhaseAdvanceCallback([this](const std::string& proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase) {
+    consensusEngine_->setPhaseAdvanceCallback([this](MessageID proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase) {
         this->sendPhaseAdvance(proposalID, fromPhase, toPhase);
     });
     
+    consensusEngine_->setLatencyCallback([this](BlockHeight height, simtime_t latency) {
+        EV_DEBUG << "[TriBFT] Block " << height << " committed " << latency << "s after its proposal" << endl;
+        emit(consensusLatencySignal_, latency);
+    });
+    
     // Update shard size
     const ShardInfo* shard = shardManager_->getShardInfo(currentShardID_);
     if (shard) {
@@ -178,6 +222,13 @@ void TriBFTApp::initializeReputation() {
     reputationManager_ = std::make_unique<VRMManager>();
     reputationManager_->initialize();
     
+    // Decay is lazy (applied when a record is read), so there is no decay timer
+    reputationManager_->setDecayInterval(vrmEnabled_ ? Constants::REPUTATION_DECAY_INTERVAL_SEC : 0.0);
+    if (sharedReputation_) {
+        reputationManager_->useSharedStore();
+    }
+    reputationManager_->setWeightLambda(reputationWeightLambda_);
+    
     reputationManager_->setLogCallback([this](const std::string& msg) {
         EV_DEBUG << "[VRM] " << msg << endl;
     });
@@ -185,12 +236,13 @@ void TriBFTApp::initializeReputation() {
     // Register self
     reputationManager_->registerNode(nodeID_, initialReputation_);
     
-    // Register other shard members
+    // Register other shard members (shared store: members register themselves)
     const ShardInfo* shard = shardManager_->getShardInfo(currentShardID_);
-    if (shard) {
-        for (const NodeID& member : shard->members) {
-            if (member != nodeID_) {
-                reputationManager_->registerNode(member, Constants::INITIAL_REPUTATION);
+    if (shard && !sharedReputation_) {
+        const NodeRegistry& registry = NodeRegistry::getGlobalInstance();
+        for (NodeIndex member : shard->members) {
+            if (member != nodeIndex_) {
+                reputationManager_->registerNode(registry.getName(member), Constants::INITIAL_REPUTATION);
             }
         }
     }
@@ -198,6 +250,38 @@ void TriBFTApp::initializeReputation() {
     EV_INFO << "[TriBFT] Reputation system initialized" << endl;
 }
 
+void TriBFTApp::initializeSync() {
+    // Committed blocks are stored here so this node can serve lagging peers
+    lightweightSync_ = std::make_unique<LightweightSync>();
+    lightweightSync_->setLogCallback([this](const std::string& msg) {
+        EV_DEBUG << msg << endl;
+    });
+    lightweightSync_->initialize(nodeRole_, nodeIndex_);
+    lightweightSync_->setShard(currentShardID_);
+    
+    rangeSync_ = std::make_unique<RangeSync>(*lightweightSync_);
+    rangeSync_->setBatching(catchUpHeaderBatch_, catchUpBodyBatch_, catchUpMaxInFlight_);
+    rangeSync_->setRetryPolicy(catchUpTimeout_, catchUpMaxAttempts_, catchUpPeerTimeout_);
+    rangeSync_->setFetchBodies(catchUpFetchBodies_);
+    rangeSync_->setCheckpointSync(catchUpCheckpoints_, consensusEngine_->getQuorumSize());
+    
+    rangeSync_->setRequestCallback([this](const RangeSync::RangeRequest& request) {
+        ConsensusCodec::Buffer payload;
+        ConsensusCodec::encodeSyncRequest(request, payload);
+        this->sendSyncPayload(payload, MT_SYNC_REQUEST, "SYNCREQ_" + std::to_string(request.requestID));
+    });
+    
+    rangeSync_->setCompleteCallback([this](const RangeSync::CatchUpStats& stats) {
+        this->onCatchUpFinished(stats);
+    });
+    
+    rangeSync_->setLogCallback([this](const std::string& msg) {
+        this->logInfo(msg);
+    });
+    
+    EV_INFO << "[TriBFT] Catch-up sync initialized" << endl;
+}
+
 void TriBFTApp::initializeTimers() {
     // Check if this node is the leader of its shard
     isLeaderNode_ = shardManager_->isShardLeader(nodeID_, currentShardID_);
@@ -226,11 +310,6 @@ void TriBFTApp::initializeTimers() {
     // Shard maintenance timer (periodic rebalancing)
     scheduleAt(simTime() + 10.0, shardMaintenanceTimer_);
     
-    // Reputation decay timer
-    if (vrmEnabled_) {
-        scheduleAt(simTime() + 5.0, reputationDecayTimer_);
-    }
-    
     // Heartbeat timer
     scheduleAt(simTime() + 1.0, heartbeatTimer_);
     
@@ -255,26 +334,42 @@ void TriBFTApp::onWSM(veins::BaseFrame1609_4* frame) {
     // 🔧 WORKAROUND: All disguised messages use TransactionMessage, handle them all first
     TransactionMessage* txMsg = dynamic_cast<TransactionMessage*>(tribftMsg);
     if (txMsg) {
+        // Catch-up traffic is single hop between in-range peers: no relay, no tx pool
+        ConsensusCodec::WireType wireType = ConsensusCodec::peekType(readPayload(txMsg));
+        if (wireType == ConsensusCodec::WireType::SYNC_REQUEST ||
+            wireType == ConsensusCodec::WireType::SYNC_HEADERS ||
+            wireType == ConsensusCodec::WireType::SYNC_BLOCKS ||
+            wireType == ConsensusCodec::WireType::SYNC_CHECKPOINTS) {
+            handleSyncMessage(txMsg);
+            return;
+        }
+        
         // First, let handleTransactionMessage process it (for forwarding, deduplication, etc.)
         handleTransactionMessage(txMsg);
         
-        // Then check if it's a disguised consensus message that needs special handling
+        // Then check if it's a disguised consensus message (type tag is the first payload byte)
         std::string txID = txMsg->getTxID();
-        if (txID.find("PROP_") == 0) {
-            // This is a disguised PROPOSAL message - handle it after forwarding
-            std::cout << "  [onWSM-DISGUISED] Processing PROPOSAL (txID=" << txID << ") from " 
-                      << tribftMsg->getSenderID() << std::endl;
-            handleDisguisedProposal(txMsg);
-        } else if (txID.find("VOTE_") == 0) {
-            // This is a disguised VOTE message - handle it after forwarding
-            std::cout << "  [onWSM-DISGUISED] Processing VOTE (txID=" << txID << ") from " 
-                      << tribftMsg->getSenderID() << std::endl;
-            handleDisguisedVote(txMsg);
-        } else if (txID.find("PHASE_") == 0) {
-            // This is a disguised PhaseAdvance message - handle it after forwarding
-            std::cout << "  [onWSM-DISGUISED] Processing PHASE-ADVANCE (txID=" << txID << ") from " 
-                      << tribftMsg->getSenderID() << std::endl;
-            handleDisguisedPhaseAdvance(txMsg);
+        switch (wireType) {
+            case ConsensusCodec::WireType::PROPOSAL:
+                // This is a disguised PROPOSAL message - handle it after forwarding
+                std::cout << "  [onWSM-DISGUISED] Processing PROPOSAL (txID=" << txID << ") from " 
+                          << tribftMsg->getSenderID() << std::endl;
+                handleDisguisedProposal(txMsg);
+                break;
+            case ConsensusCodec::WireType::VOTE:
+                // This is a disguised VOTE message - handle it after forwarding
+                std::cout << "  [onWSM-DISGUISED] Processing VOTE (txID=" << txID << ") from " 
+                          << tribftMsg->getSenderID() << std::endl;
+                handleDisguisedVote(txMsg);
+                break;
+            case ConsensusCodec::WireType::PHASE_ADVANCE:
+                // This is a disguised PhaseAdvance message - handle it after forwarding
+                std::cout << "  [onWSM-DISGUISED] Processing PHASE-ADVANCE (txID=" << txID << ") from " 
+                          << tribftMsg->getSenderID() << std::endl;
+                handleDisguisedPhaseAdvance(txMsg);
+                break;
+            default:
+                break;
         }
         return;
     }
@@ -335,12 +430,13 @@ void TriBFTApp::handleSelfMsg(cMessage* msg) {
     else if (msg == shardMaintenanceTimer_) {
         handleShardMaintenanceTimer();
     }
-    else if (msg == reputationDecayTimer_) {
-        handleReputationDecayTimer();
-    }
     else if (msg == heartbeatTimer_) {
         handleHeartbeatTimer();
     }
+    else if (msg == syncTimer_) {
+        rangeSync_->tick();
+        scheduleSyncTimer();
+    }
     else if (msg == txGenerationTimer_) {
         // 处理交易生成定时器（高频日志已禁用）
         // std::cout << "[TX-GEN-TRIGGER] autoGenerateTx=" << autoGenerateTx_ << std::endl;
@@ -411,14 +507,42 @@ void TriBFTApp::handlePositionUpdate(cObject* obj) {
     
     // Update location in shard manager
     GeoCoord newLocation = getCurrentLocation();
-    ShardID newShardID = shardManager_->updateNodeLocation(nodeID_, newLocation);
+    ShardID newShardID = shardManager_->updateNodeLocation(nodeIndex_, newLocation);
     
     if (newShardID != currentShardID_ && newShardID != -1) {
         EV_INFO << "[TriBFT] Moved to new shard " << newShardID << endl;
         currentShardID_ = newShardID;
         
-        // Re-initialize consensus with new shard
-        initializeConsensus();
+        // Stored headers and a running catch-up follow the old shard's chain
+        rangeSync_->reset();
+        lightweightSync_->setShard(newShardID);
+        cancelEvent(syncTimer_);
+        
+        if (!incrementalHandoff_ || !consensusEngine_) {
+            // Re-initialize consensus with new shard
+            initializeConsensus();
+        } else {
+            // Incremental handoff: keep the engine, drop only old-shard state
+            consensusEngine_->switchShard(newShardID);
+            const ShardInfo* shard = shardManager_->getShardInfo(currentShardID_);
+            if (shard) {
+                consensusEngine_->setShardSize(shard->getMemberCount());
+            }
+            
+            bool wasLeader = isLeaderNode_;
+            isLeaderNode_ = shardManager_->isShardLeader(nodeID_, currentShardID_);
+            if (wasLeader != isLeaderNode_) {
+                if (consensusTimer_->isScheduled()) {
+                    cancelEvent(consensusTimer_);
+                }
+                if (isLeaderNode_) {
+                    scheduleAt(simTime() + blockInterval_, consensusTimer_);
+                }
+            }
+        }
+        
+        // Role and voter slots come from the new shard's group
+        electConsensusGroup();
     }
 }
 
@@ -427,26 +551,25 @@ void TriBFTApp::handlePositionUpdate(cObject* obj) {
 // ============================================================================
 
 void TriBFTApp::handleDisguisedProposal(TransactionMessage* msg) {
-    std::string txData = msg->getTxData();
     std::string senderID = msg->getSenderID();
     
-    // Parse PROPOSAL data (format: "proposalID|blockHash|height|leaderID|txCount")
-    std::istringstream iss(txData);
-    std::string proposalID, blockHash, leaderID;
-    int blockHeight, txCount;
+    // Decode PROPOSAL payload (ConsensusCodec)
+    ConsensusProposal received;
+    uint32_t txCount = 0;
+    if (!ConsensusCodec::decodeProposal(readPayload(msg), received, txCount)) {
+        EV_WARN << "[TriBFT] Malformed PROPOSAL payload from " << senderID << endl;
+        return;
+    }
+    MessageID proposalID = received.proposalID;
+    const NodeID& leaderID = received.leaderID;
     
-    std::getline(iss, proposalID, '|');
-    std::getline(iss, blockHash, '|');
-    iss >> blockHeight;
-    iss.ignore(1);  // skip '|'
-    std::getline(iss, leaderID, '|');
-    iss >> txCount;
+    std::cout << "  [RECV] Got disguised PROPOSAL " << IdGenerator::toString(proposalID) 
+              << " from " << senderID << " (height=" << received.blockHeight << ", txs=" << txCount << ")" << std::endl;
     
-    std::cout << "  [RECV] Got disguised PROPOSAL " << proposalID 
-              << " from " << senderID << " (height=" << blockHeight << ", txs=" << txCount << ")" << std::endl;
+    checkCatchUp(leaderID, received.shardID, received.blockHeight);
     
     // Vote on the proposal
-    std::cout << "  [VOTE] " << nodeID_ << " voting YES for " << proposalID << std::endl;
+    std::cout << "  [VOTE] " << nodeID_ << " voting YES for " << IdGenerator::toString(proposalID) << std::endl;
     
     VoteInfo vote;
     vote.voterID = nodeID_;
@@ -464,58 +587,39 @@ void TriBFTApp::handleDisguisedProposal(TransactionMessage* msg) {
 }
 
 void TriBFTApp::handleDisguisedVote(TransactionMessage* msg) {
-    std::string txData = msg->getTxData();
     std::string senderID = msg->getSenderID();
     
-    // Parse VOTE data (format: "proposalID|phase|approve|signature")
-    std::istringstream iss(txData);
-    std::string proposalID, signature, approveStr;
-    int phase;
-    
-    std::getline(iss, proposalID, '|');
-    iss >> phase;
-    iss.ignore(1);  // skip '|'
-    std::getline(iss, approveStr, '|');
-    std::getline(iss, signature);
-    
-    bool approve = (approveStr == "1");
-    
-    std::cout << "  [RECV-VOTE] From " << senderID << " for " << proposalID 
-              << " phase=" << phase << " approve=" << approve << std::endl;
-    
+    // Decode VOTE payload (ConsensusCodec); the voter is the message sender
     VoteInfo vote;
+    if (!ConsensusCodec::decodeVote(readPayload(msg), vote)) {
+        EV_WARN << "[TriBFT] Malformed VOTE payload from " << senderID << endl;
+        return;
+    }
     vote.voterID = senderID;
-    vote.proposalID = proposalID;
-    vote.phase = static_cast<ConsensusPhase>(phase);
-    vote.approve = approve;
-    vote.signature = signature;
+    
+    std::cout << "  [RECV-VOTE] From " << senderID << " for " << IdGenerator::toString(vote.proposalID) 
+              << " phase=" << static_cast<int>(vote.phase) << " approve=" << vote.approve << std::endl;
     
     // Process the vote
     consensusEngine_->handleVote(vote);
 }
 
 void TriBFTApp::handleDisguisedPhaseAdvance(TransactionMessage* msg) {
-    std::string txData = msg->getTxData();
     std::string senderID = msg->getSenderID();
     
-    // Parse PhaseAdvance data (format: "proposalID|fromPhase|toPhase")
-    std::istringstream iss(txData);
-    std::string proposalID;
-    int fromPhase, toPhase;
-    
-    std::getline(iss, proposalID, '|');
-    iss >> fromPhase;
-    iss.ignore(1);  // skip '|'
-    iss >> toPhase;
+    // Decode PhaseAdvance payload (ConsensusCodec)
+    MessageID proposalID = Constants::INVALID_MESSAGE_ID;
+    ConsensusPhase fromPhase, toPhase;
+    if (!ConsensusCodec::decodePhaseAdvance(readPayload(msg), proposalID, fromPhase, toPhase)) {
+        EV_WARN << "[TriBFT] Malformed PHASE-ADVANCE payload from " << senderID << endl;
+        return;
+    }
     
-    std::cout << "  [RECV-PHASE-ADV] From " << senderID << " for " << proposalID 
-              << ": phase " << fromPhase << " -> " << toPhase << std::endl;
+    std::cout << "  [RECV-PHASE-ADV] From " << senderID << " for " << IdGenerator::toString(proposalID) 
+              << ": phase " << static_cast<int>(fromPhase) << " -> " << static_cast<int>(toPhase) << std::endl;
     
     // Pass to consensus engine
-    consensusEngine_->handlePhaseAdvance(
-        proposalID,
-        static_cast<ConsensusPhase>(toPhase)
-    );
+    consensusEngine_->handlePhaseAdvance(proposalID, toPhase);
 }
 
 // ============================================================================
@@ -531,21 +635,19 @@ void TriBFTApp::handleTransactionMessage(TransactionMessage* msg) {
     int targetShardId = msg->getTargetShardId();
     
     // 🔍 Debug for disguised messages
-    bool isDisguised = (txID.find("PROP_") == 0 || txID.find("VOTE_") == 0 || txID.find("PHASE_") == 0);
+    bool isDisguised = (msg->getPayloadArraySize() > 0);
     if (isDisguised) {
         std::cout << "  [TX-HANDLER-DEBUG] Processing disguised msg: txID=" << txID 
                   << ", hop=" << hopCount << ", targetShard=" << targetShardId 
                   << ", myShard=" << currentShardID_ << std::endl;
     }
     
-    // 🆕 防止循环转发：检查是否已经见过这笔交?    if (seenTxIds_.find(txID) != seenTxIds_.end()) {
+    // 🆕 防止循环转发：检查是否已经见过这笔交?    if (seenTxIds_.testAndInsert(txID, simTime())) {
         // 已经处理过，直接丢弃
         if (isDisguised) std::cout << "  [TX-HANDLER-DEBUG] Already seen, discarding" << std::endl;
         return;
     }
     
-    // 标记为已?    seenTxIds_.insert(txID);
-    
     // 🆕 智能转发：分片过?    // 只处理本分片的交易（targetShardId == -1 表示广播，或者等于当前分片）
     if (targetShardId != -1 && !isInTargetShard(targetShardId)) {
         // 不属于本分片，丢?        if (isDisguised) std::cout << "  [TX-HANDLER-DEBUG] Wrong shard, discarding" << std::endl;
@@ -611,24 +713,19 @@ void TriBFTApp::handleTransactionMessage(TransactionMessage* msg) {
 void TriBFTApp::handleProposalMessage(ProposalMessage* msg) {
     if (!msg) return;
     
-    std::cout << "  [RECV] " << nodeID_ << " got proposal " << msg->getProposalID() 
+    std::cout << "  [RECV] " << nodeID_ << " got proposal " << IdGenerator::toString(msg->getProposalID()) 
               << " from " << msg->getLeaderID() 
               << " height=" << msg->getBlockHeight() << std::endl;
     
     // 🆕 首先同步区块高度（在检查角色之前）
     // 即使是ORDINARY节点也需要同步高度以保持一致?    BlockHeight proposalHeight = msg->getBlockHeight();
-    BlockHeight currentHeight = consensusEngine_->getCurrentHeight();
-    if (proposalHeight > currentHeight + 1) {
-        std::cout << "  [SYNC] " << nodeID_ << " syncing height from " 
-                  << currentHeight << " to " << (proposalHeight - 1) << std::endl;
-        // 在实际系统中，这里应该请求缺失的区块
-        // 简化处理：直接更新高度（假设已经同步了缺失的区块）
-        consensusEngine_->syncToHeight(proposalHeight - 1);
-    }
+    // Missing heights are fetched from in-range peers (RangeSync); the engine
+    // moves to proposalHeight - 1 once the header chain is verified
+    checkCatchUp(msg->getLeaderID(), msg->getShardID(), proposalHeight);
     
     // 🆕 自动更新节点角色（follower节点查询共识组）
     if (nodeRole_ == NodeRole::ORDINARY && shardManager_) {
-        NodeRole newRole = shardManager_->getNodeRole(nodeID_, currentShardID_);
+        NodeRole newRole = shardManager_->getNodeRole(nodeIndex_, currentShardID_);
         if (newRole != NodeRole::ORDINARY) {
             nodeRole_ = newRole;
             std::cout << "  [ROLE-UPDATE] " << nodeID_ << " updated role to " << (int)newRole << std::endl;
@@ -698,6 +795,11 @@ void TriBFTApp::handlePhaseAdvanceMessage(PhaseAdvanceMessage* msg) {
 void TriBFTApp::handleDecideMessage(DecideMessage* msg) {
     if (!msg) return;
     
+    // Sender has committed up to this height (of its own shard's chain)
+    if (msg->getCommitted() && msg->getShardID() == currentShardID_) {
+        rangeSync_->notePeer(NodeRegistry::getGlobalInstance().intern(msg->getSenderID()), msg->getBlockHeight());
+    }
+    
     EV_INFO << "[TriBFT] Received decision for block " << msg->getBlockHeight() 
             << " (" << (msg->getCommitted() ? "COMMITTED" : "REJECTED") << ")" << endl;
 }
@@ -750,6 +852,218 @@ void TriBFTApp::handleReputationUpdate(ReputationUpdateMessage* msg) {
 
 void TriBFTApp::handleHeartbeat(HeartbeatMessage* msg) {
     EV_DEBUG << "[TriBFT] Heartbeat from " << msg->getSenderID() << endl;
+    if (msg->getShardID() == currentShardID_) {
+        rangeSync_->notePeer(NodeRegistry::getGlobalInstance().intern(msg->getSenderID()), msg->getBlockHeight());
+    }
+}
+
+// ============================================================================
+// CATCH-UP
+// ============================================================================
+
+void TriBFTApp::checkCatchUp(const NodeID& leaderID, ShardID shardID, BlockHeight proposalHeight) {
+    NodeRegistry& registry = NodeRegistry::getGlobalInstance();
+    
+    // Another shard's height says nothing about this shard's chain
+    if (shardID != currentShardID_) {
+        return;
+    }
+    
+    // The leader has committed everything below its proposal
+    if (leaderID != nodeID_ && proposalHeight > 0) {
+        rangeSync_->notePeer(registry.intern(leaderID), proposalHeight - 1);
+    }
+    
+    BlockHeight currentHeight = consensusEngine_->getCurrentHeight();
+    if (proposalHeight <= currentHeight + 1) {
+        return;
+    }
+    BlockHeight target = proposalHeight - 1;
+    
+    if (!rangeSync_->isActive() && shardManager_) {
+        // Consensus members of this shard hold full blocks; assume they are level with
+        // the leader (a member that is not answers short and is asked no further)
+        ConsensusGroup group = shardManager_->getCurrentConsensusGroup(currentShardID_);
+        for (const std::vector<NodeID>* members : {&group.primaryNodes, &group.redundantNodes}) {
+            for (const NodeID& member : *members) {
+                if (member != nodeID_ && member != leaderID) {
+                    rangeSync_->notePeer(registry.intern(member), target);
+                }
+            }
+        }
+        
+        EV_INFO << "[SYNC] " << nodeID_ << " catching up from " << currentHeight
+                << " to " << target << " (" << rangeSync_->getPeerCount() << " peers in range)" << endl;
+    }
+    
+    rangeSync_->start(target, currentHeight + 1);
+    scheduleSyncTimer();
+}
+
+void TriBFTApp::handleSyncMessage(TransactionMessage* msg) {
+    ConsensusCodec::Buffer payload = readPayload(msg);
+    NodeIndex sender = NodeRegistry::getGlobalInstance().intern(msg->getSenderID());
+    
+    switch (ConsensusCodec::peekType(payload)) {
+        case ConsensusCodec::WireType::SYNC_REQUEST: {
+            SyncRequest request;
+            if (!ConsensusCodec::decodeSyncRequest(payload, request)) {
+                EV_WARN << "[TriBFT] Malformed SYNC_REQUEST from " << msg->getSenderID() << endl;
+                return;
+            }
+            // Only this shard's chain is stored; other shards' requests go unanswered
+            if (request.peer == nodeIndex_ && request.shardID == currentShardID_) {
+                serveSyncRequest(request);
+            }
+            return;
+        }
+        case ConsensusCodec::WireType::SYNC_HEADERS: {
+            MessageID requestID = Constants::INVALID_MESSAGE_ID;
+            ShardID shardID = -1;
+            BlockHeight servedHeight = 0;
+            std::vector<BlockHeader> headers;
+            if (!ConsensusCodec::decodeSyncHeaders(payload, requestID, shardID, servedHeight, headers)) {
+                EV_WARN << "[TriBFT] Malformed SYNC_HEADERS from " << msg->getSenderID() << endl;
+                return;
+            }
+            if (shardID != currentShardID_) {
+                return;
+            }
+            // Overheard answers still tell which peers are in range and how far they reach
+            rangeSync_->notePeer(sender, servedHeight);
+            if (IdGenerator::getNode(requestID) == nodeIndex_) {
+                rangeSync_->onHeaders(requestID, headers);
+            }
+            break;
+        }
+        case ConsensusCodec::WireType::SYNC_BLOCKS: {
+            MessageID requestID = Constants::INVALID_MESSAGE_ID;
+            ShardID shardID = -1;
+            BlockHeight servedHeight = 0;
+            std::vector<Block> blocks;
+            if (!ConsensusCodec::decodeSyncBlocks(payload, requestID, shardID, servedHeight, blocks)) {
+                EV_WARN << "[TriBFT] Malformed SYNC_BLOCKS from " << msg->getSenderID() << endl;
+                return;
+            }
+            if (shardID != currentShardID_) {
+                return;
+            }
+            rangeSync_->notePeer(sender, servedHeight);
+            if (IdGenerator::getNode(requestID) == nodeIndex_) {
+                rangeSync_->onBlocks(requestID, blocks);
+            }
+            break;
+        }
+        case ConsensusCodec::WireType::SYNC_CHECKPOINTS: {
+            MessageID requestID = Constants::INVALID_MESSAGE_ID;
+            ShardID shardID = -1;
+            BlockHeight servedHeight = 0;
+            std::vector<CheckpointHeader> path;
+            if (!ConsensusCodec::decodeSyncCheckpoints(payload, requestID, shardID, servedHeight, path)) {
+                EV_WARN << "[TriBFT] Malformed SYNC_CHECKPOINTS from " << msg->getSenderID() << endl;
+                return;
+            }
+            if (shardID != currentShardID_) {
+                return;
+            }
+            rangeSync_->notePeer(sender, servedHeight);
+            if (IdGenerator::getNode(requestID) == nodeIndex_) {
+                rangeSync_->onCheckpoints(requestID, path);
+            }
+            break;
+        }
+        default:
+            return;
+    }
+    scheduleSyncTimer();
+}
+
+void TriBFTApp::serveSyncRequest(const SyncRequest& request) {
+    // Only what is stored, consecutive headers from request.first; the requester re-asks elsewhere for the rest
+    uint32_t count = std::min(request.count, RangeSync::MAX_BATCH);
+    BlockHeight servedHeight = lightweightSync_->getLatestHeight();
+    ConsensusCodec::Buffer payload;
+    
+    if (request.kind == SyncRangeKind::HEADERS) {
+        std::vector<const BlockHeader*> headers;
+        for (BlockHeight height = request.first; height < request.first + count; ++height) {
+            const BlockHeader* header = lightweightSync_->getHeader(height);
+            if (!header) {
+                break;
+            }
+            headers.push_back(header);
+        }
+        ConsensusCodec::encodeSyncHeaders(request.requestID, currentShardID_, servedHeight, headers, payload);
+    } else if (request.kind == SyncRangeKind::CHECKPOINTS) {
+        // Newest checkpoint up to the requested target (empty path if it cannot be proven)
+        BlockHeight bound = request.first + request.count;
+        BlockHeight target = std::min(bound - bound % Constants::CHECKPOINT_INTERVAL,
+                                      lightweightSync_->getLatestCheckpoint().height);
+        std::vector<CheckpointHeader> path;
+        if (target > request.first) {
+            lightweightSync_->getCheckpointProof(request.first, target, path);
+        }
+        ConsensusCodec::encodeSyncCheckpoints(request.requestID, currentShardID_, servedHeight, path, payload);
+    } else {
+        std::vector<const Block*> blocks;
+        for (BlockHeight height = request.first; height < request.first + count; ++height) {
+            const Block* block = lightweightSync_->getFullBlock(height);
+            if (block) {
+                blocks.push_back(block);
+            }
+        }
+        ConsensusCodec::encodeSyncBlocks(request.requestID, currentShardID_, servedHeight, blocks, payload);
+    }
+    
+    sendSyncPayload(payload, MT_SYNC_RESPONSE, "SYNCRSP_" + std::to_string(request.requestID));
+}
+
+void TriBFTApp::sendSyncPayload(const ConsensusCodec::Buffer& payload, int actualType, const std::string& txID) {
+    TransactionMessage* msg = new TransactionMessage();
+    msg->setSenderID(nodeID_.c_str());
+    msg->setTimestamp(simTime());
+    msg->setActualMessageType(actualType);
+    attachPayload(msg, payload);
+    msg->setTxID(txID.c_str());
+    
+    // Broadcast to neighbours only (onWSM never relays sync payloads)
+    msg->setRecipientAddress(-1);
+    msg->setChannelNumber(static_cast<int>(veins::Channel::cch));
+    msg->setHopCount(0);
+    msg->setSenderDistanceToLeader(-1.0);
+    msg->setTargetShardId(-1);
+    
+    sendDown(msg);
+}
+
+void TriBFTApp::onCatchUpFinished(const RangeSync::CatchUpStats& stats) {
+    if (stats.completed) {
+        const BlockHeader* tip = lightweightSync_->getHeader(stats.target);
+        consensusEngine_->syncToHeight(stats.target, tip ? tip->blockHash : "");
+        emit(catchUpTimeSignal_, stats.duration);
+        emit(catchUpBlocksSignal_, static_cast<long>(stats.target - stats.from + 1));
+        
+        EV_INFO << "[SYNC] " << nodeID_ << " caught up to " << stats.target << " in "
+                << stats.duration << "s (" << stats.requests << " requests, " << stats.retries
+                << " retries, " << stats.peersUsed << " peers, " << stats.skippedBodies
+                << " bodies skipped)" << endl;
+    } else {
+        // Nobody could serve the range: follow the leader's height unverified so the node keeps voting
+        consensusEngine_->syncToHeight(stats.target);
+        emit(catchUpFailedSignal_, 1L);
+        
+        EV_WARN << "[SYNC] " << nodeID_ << " catch-up to " << stats.target
+                << " failed, adopting height unverified" << endl;
+    }
+    emit(catchUpRetriesSignal_, static_cast<long>(stats.retries));
+}
+
+void TriBFTApp::scheduleSyncTimer() {
+    cancelEvent(syncTimer_);
+    simtime_t deadline = rangeSync_->getNextDeadline();
+    if (rangeSync_->isActive() && deadline > SIMTIME_ZERO) {
+        scheduleAt(std::max(deadline, simTime()), syncTimer_);
+    }
 }
 
 // ============================================================================
@@ -757,7 +1071,7 @@ void TriBFTApp::handleHeartbeat(HeartbeatMessage* msg) {
 // ============================================================================
 
 void TriBFTApp::onProposalGenerated(const ConsensusProposal& proposal) {
-    EV_INFO << "[TriBFT] Broadcasting proposal " << proposal.proposalID 
+    EV_INFO << "[TriBFT] Broadcasting proposal " << IdGenerator::toString(proposal.proposalID) 
             << " with " << proposal.transactions.size() << " transactions" << endl;
     sendProposal(proposal);
 }
@@ -766,7 +1080,7 @@ void TriBFTApp::onVoteGenerated(const tribft::VoteInfo& vote) {
     sendVote(vote);
 }
 
-void TriBFTApp::onBlockCommitted(const Block& block) {
+void TriBFTApp::onBlockCommitted(const Block& block, const QuorumCertificate& qc) {
     EV_INFO << "[TriBFT] Block " << block.height << " committed with " 
             << block.transactions.size() << " transactions" << endl;
     
@@ -775,12 +1089,22 @@ void TriBFTApp::onBlockCommitted(const Block& block) {
     // Emit statistics
     emit(blockCommittedSignal_, 1L);
     
+    // Keep the block servable to lagging peers; an own commit that does not
+    // extend the stored chain (after an unverified height jump) restarts it
+    BlockHeader header = BlockHeader::fromBlock(block);
+    if (!lightweightSync_->syncHeader(header)) {
+        lightweightSync_->clear();
+        lightweightSync_->syncHeader(header);
+    }
+    lightweightSync_->receiveFullBlock(block);
+    
+    // Only the leader's engine collects votes, so commit QCs (and with them
+    // checkpoints) exist on leaders only; they serve proofs to everyone else
+    lightweightSync_->syncCheckpoint(header, qc);
+    
     // Update reputation for participants
     if (vrmEnabled_) {
-        std::vector<NodeID> participants;
-        for (const auto& vote : block.qc.votes) {
-            participants.push_back(vote.voterID);
-        }
+        std::vector<NodeID> participants = consensusEngine_->getVoters(qc);
         reputationManager_->updateForConsensusSuccess(participants);
     }
     
@@ -882,19 +1206,12 @@ void TriBFTApp::handleShardMaintenanceTimer() {
         emit(shardSizeSignal_, static_cast<long>(shard->getMemberCount()));
     }
     
-    scheduleAt(simTime() + 10.0, shardMaintenanceTimer_);
-}
-
-void TriBFTApp::handleReputationDecayTimer() {
+    // Emit reputation signal (read applies any pending decay)
     if (vrmEnabled_) {
-        reputationManager_->applyDecay();
-        
-        // Emit reputation signal
-        double rep = reputationManager_->getReputation(nodeID_);
-        emit(reputationSignal_, rep);
+        emit(reputationSignal_, reputationManager_->getReputation(nodeID_));
     }
     
-    scheduleAt(simTime() + 5.0, reputationDecayTimer_);
+    scheduleAt(simTime() + 10.0, shardMaintenanceTimer_);
 }
 
 void TriBFTApp::handleHeartbeatTimer() {
@@ -946,16 +1263,12 @@ void TriBFTApp::sendProposal(const ConsensusProposal& proposal) {
     // 🔧 Mark this as a disguised PROPOSAL message
     msg->setActualMessageType(MT_PROPOSAL);
     
-    // Serialize PROPOSAL data into txData field (format: "proposalID|blockHash|height|leaderID|txCount")
-    std::ostringstream oss;
-    oss << proposal.proposalID << "|"
-        << proposal.blockHash << "|"
-        << proposal.blockHeight << "|"
-        << proposal.leaderID << "|"
-        << proposal.transactions.size();
-    msg->setTxData(oss.str().c_str());
-    // 🔧 WORKAROUND: Use txID prefix to identify message type (Veins doesn't transmit actualMessageType)
-    std::string txID = "PROP_" + proposal.proposalID;
+    // Encode PROPOSAL header into binary payload (ConsensusCodec)
+    ConsensusCodec::Buffer payload;
+    ConsensusCodec::encodeProposal(proposal, payload);
+    attachPayload(msg, payload);
+    // txID only serves duplicate suppression; the type comes from the payload tag
+    std::string txID = "PROP_" + std::to_string(proposal.proposalID);
     msg->setTxID(txID.c_str());
     
     // Set Veins network parameters (same as real TX)
@@ -965,11 +1278,11 @@ void TriBFTApp::sendProposal(const ConsensusProposal& proposal) {
     msg->setSenderDistanceToLeader(-1.0);
     msg->setTargetShardId(proposal.shardID);
     
-    std::cout << "  [SEND-PROPOSAL-DISGUISED] " << proposal.proposalID << " as TX" << std::endl;
+    std::cout << "  [SEND-PROPOSAL-DISGUISED] " << IdGenerator::toString(proposal.proposalID) << " as TX" << std::endl;
     std::cout << "  [DEBUG-SEND] actualType=" << msg->getActualMessageType() 
               << " (MT_PROPOSAL=" << MT_PROPOSAL << ")" << std::endl;
     std::cout << "  [DEBUG-SEND] txID=" << msg->getTxID() 
-              << ", txData=" << msg->getTxData() << std::endl;
+              << ", payload=" << payload.size() << " bytes" << std::endl;
     
     // 🔧 修复：立即本地处理自己的PROPOSAL（因为广播不会发送给自己?    handleDisguisedProposal(msg);
     
@@ -989,15 +1302,12 @@ void TriBFTApp::sendVote(const tribft::VoteInfo& vote) {
                    static_cast<int>(vote.phase) == 2 ? MT_VOTE_PRE_COMMIT : MT_VOTE_COMMIT;
     msg->setActualMessageType(voteType);
     
-    // Serialize VOTE data (format: "proposalID|phase|approve|signature")
-    std::ostringstream oss;
-    oss << vote.proposalID << "|"
-        << static_cast<int>(vote.phase) << "|"
-        << (vote.approve ? "1" : "0") << "|"
-        << vote.signature;
-    msg->setTxData(oss.str().c_str());
-    // 🔧 WORKAROUND: Use txID prefix to identify message type
-    std::string txID = "VOTE_" + vote.proposalID + "_" + vote.voterID;
+    // Encode VOTE into binary payload (ConsensusCodec)
+    ConsensusCodec::Buffer payload;
+    ConsensusCodec::encodeVote(vote, payload);
+    attachPayload(msg, payload);
+    // txID only serves duplicate suppression
+    std::string txID = "VOTE_" + std::to_string(vote.proposalID) + "_" + vote.voterID;
     msg->setTxID(txID.c_str());
     
     // Set Veins network parameters
@@ -1008,14 +1318,14 @@ void TriBFTApp::sendVote(const tribft::VoteInfo& vote) {
     msg->setTargetShardId(currentShardID_);
     
     std::cout << "  [VOTE-DISGUISED] " << nodeID_ << " voting " 
-              << (vote.approve ? "YES" : "NO") << " for " << vote.proposalID << " (as TX)" << std::endl;
+              << (vote.approve ? "YES" : "NO") << " for " << IdGenerator::toString(vote.proposalID) << " (as TX)" << std::endl;
     
     // 🔧 修复：立即本地处理自己的投票（因为广播不会发送给自己?    consensusEngine_->handleVote(vote);
     
     // 然后广播给其他节?    sendDown(msg);
 }
 
-void TriBFTApp::sendPhaseAdvance(const std::string& proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase) {
+void TriBFTApp::sendPhaseAdvance(MessageID proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase) {
     // 🔧 WORKAROUND: Disguise PhaseAdvance as TransactionMessage
     TransactionMessage* msg = new TransactionMessage();
     
@@ -1025,13 +1335,13 @@ void TriBFTApp::sendPhaseAdvance(const std::string& proposalID, ConsensusPhase f
     // Mark as disguised PhaseAdvance
     msg->setActualMessageType(MT_PHASE_ADVANCE);
     
-    // Serialize PhaseAdvance data (format: "proposalID|fromPhase|toPhase")
-    std::ostringstream oss;
-    oss << proposalID << "|" << static_cast<int>(fromPhase) << "|" << static_cast<int>(toPhase);
-    msg->setTxData(oss.str().c_str());
+    // Encode PhaseAdvance into binary payload (ConsensusCodec)
+    ConsensusCodec::Buffer payload;
+    ConsensusCodec::encodePhaseAdvance(proposalID, fromPhase, toPhase, payload);
+    attachPayload(msg, payload);
     
-    // 🔧 WORKAROUND: Use txID prefix to identify message type
-    std::string txID = "PHASE_" + proposalID + "_" + std::to_string(static_cast<int>(toPhase));
+    // txID only serves duplicate suppression
+    std::string txID = "PHASE_" + std::to_string(proposalID) + "_" + std::to_string(static_cast<int>(toPhase));
     msg->setTxID(txID.c_str());
     
     // Set Veins network parameters
@@ -1042,7 +1352,7 @@ void TriBFTApp::sendPhaseAdvance(const std::string& proposalID, ConsensusPhase f
     msg->setTargetShardId(currentShardID_);
     
     std::cout << "  [PHASE-ADV-SEND] " << nodeID_ << " broadcasting phase advance: " 
-              << (int)fromPhase << " -> " << (int)toPhase << " for " << proposalID << " (as TX)" << std::endl;
+              << (int)fromPhase << " -> " << (int)toPhase << " for " << IdGenerator::toString(proposalID) << " (as TX)" << std::endl;
     
     // 🔧 修复：立即本地处?    handleDisguisedPhaseAdvance(msg);
     
@@ -1054,7 +1364,7 @@ void TriBFTApp::sendDecision(const Block& block) {
     DecideMessage* msg = new DecideMessage();
     msg->setMessageType(MT_DECIDE);
     msg->setSenderID(nodeID_.c_str());
-    msg->setProposalID(block.blockHash.c_str());
+    msg->setShardID(currentShardID_);
     msg->setBlockHash(block.blockHash.c_str());
     msg->setBlockHeight(block.height);
     msg->setCommitted(true);
@@ -1104,11 +1414,31 @@ void TriBFTApp::sendHeartbeat() {
     msg->setShardID(currentShardID_);
     msg->setCurrentLoad(0.0);
     msg->setActiveTxCount(txPool_.size());
+    msg->setBlockHeight(lightweightSync_->getLatestHeight());
     msg->setTimestamp(simTime());
     
     sendDown(msg);
 }
 
+void TriBFTApp::attachPayload(TransactionMessage* msg, const ConsensusCodec::Buffer& payload) const {
+    msg->setPayloadArraySize(payload.size());
+    for (size_t i = 0; i < payload.size(); ++i) {
+        msg->setPayload(i, payload[i]);
+    }
+    
+    // Charge the exact encoded size (plus application header) to the 802.11p frame
+    msg->setBitLength(headerLength);
+    msg->addByteLength(payload.size());
+}
+
+ConsensusCodec::Buffer TriBFTApp::readPayload(const TransactionMessage* msg) const {
+    ConsensusCodec::Buffer payload(msg->getPayloadArraySize());
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = msg->getPayload(i);
+    }
+    return payload;
+}
+
 // ============================================================================
 // UTILITY
 // ============================================================================
@@ -1232,6 +1562,12 @@ void TriBFTApp::recordStatistics() {
         EV_INFO << "[Stats] Reliable nodes: " << stats.reliableNodes << endl;
         EV_INFO << "[Stats] Average reputation: " << stats.averageScore << endl;
     }
+    
+    const DedupFilter::Stats& dedup = seenTxIds_.getStats();
+    EV_INFO << "[Stats] Dedup hit rate: " << seenTxIds_.getHitRate()
+            << " (" << dedup.hits << "/" << dedup.queries << ")" << endl;
+    EV_INFO << "[Stats] Dedup evictions: " << dedup.evictions
+            << " (rotations=" << dedup.rotations << ", memory=" << seenTxIds_.getMemoryBytes() << "B)" << endl;
 }
 
 // ============================================================================
@@ -1249,7 +1585,7 @@ void TriBFTApp::electConsensusGroup() {
     ConsensusGroup group = shardManager_->electConsensusGroup(currentShardID_, currentEpoch);
     
     // 更新本节点的角色
-    nodeRole_ = shardManager_->getNodeRole(nodeID_, currentShardID_);
+    nodeRole_ = shardManager_->getNodeRole(nodeIndex_, currentShardID_);
     lastElectionEpoch_ = currentEpoch;
     
     // 打印选举结果
@@ -1270,8 +1606,27 @@ void TriBFTApp::electConsensusGroup() {
               << std::endl;
     
     // 更新共识引擎的分片大小（只有共识群组大小，而非整个分片?    if (consensusEngine_) {
+        // No candidates: the shard's members are the voters, so votes are still counted
+        if (group.getTotalSize() == 0) {
+            group = getShardRoster(currentEpoch);
+        }
         consensusEngine_->setShardSize(group.getTotalSize());
+        consensusEngine_->setConsensusGroup(group);
+    }
+}
+
+ConsensusGroup TriBFTApp::getShardRoster(int epoch) const {
+    ConsensusGroup roster;
+    roster.epoch = epoch;
+    const ShardInfo* shard = shardManager_->getShardInfo(currentShardID_);
+    if (shard) {
+        const NodeRegistry& registry = NodeRegistry::getGlobalInstance();
+        for (NodeIndex member : shard->members) {
+            roster.primaryNodes.push_back(registry.getName(member));
+        }
+        roster.buildIndex();
     }
+    return roster;
 }
 
 bool TriBFTApp::needsReelection() const {
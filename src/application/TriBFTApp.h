@@ -3,11 +3,15 @@
 
 #include "veins/modules/application/ieee80211p/DemoBaseApplLayer.h"
 #include "../messages/TriBFTMessage_m.h"
+#include "../messages/ConsensusCodec.h"
 #include "../common/TriBFTDefs.h"
 #include "../shard/RegionalShardManager.h"
 #include "../consensus/HotStuffEngine.h"
+#include "../blockchain/LightweightSync.h"
+#include "../blockchain/RangeSync.h"
+#include "../blockchain/BlockLog.h"
 #include "../reputation/VRMManager.h"
-#include <set>  // 🆕 用于seenTxIds_
+#include "../common/DedupFilter.h"
 
 namespace tribft {
 
@@ -51,6 +55,7 @@ private:
     void initializeShard();
     void initializeConsensus();
     void initializeReputation();
+    void initializeSync();
     void initializeTimers();
     
     // ========================================================================
@@ -73,13 +78,42 @@ private:
     void handleDisguisedVote(TransactionMessage* msg);
     void handleDisguisedPhaseAdvance(TransactionMessage* msg);
     
+    // ========================================================================
+    // CATCH-UP (lagging node range sync, see RangeSync)
+    // ========================================================================
+    
+    /**
+     * @brief Note the leader as a peer and start/extend catch-up if the proposal is ahead
+     * 
+     * Proposals of another shard (shardID) are ignored.
+     */
+    void checkCatchUp(const NodeID& leaderID, ShardID shardID, BlockHeight proposalHeight);
+    
+    /**
+     * @brief Handle SYNC_* payloads (single hop, never relayed)
+     */
+    void handleSyncMessage(TransactionMessage* msg);
+    
+    /**
+     * @brief Answer a range request with the headers / bodies / checkpoint proof this node stores
+     */
+    void serveSyncRequest(const SyncRequest& request);
+    
+    void sendSyncPayload(const ConsensusCodec::Buffer& payload, int actualType, const std::string& txID);
+    void onCatchUpFinished(const RangeSync::CatchUpStats& stats);
+    
+    /**
+     * @brief Re-arm syncTimer_ at the earliest outstanding request deadline
+     */
+    void scheduleSyncTimer();
+    
     // ========================================================================
     // CONSENSUS CALLBACKS
     // ========================================================================
     
     void onProposalGenerated(const ConsensusProposal& proposal);
     void onVoteGenerated(const tribft::VoteInfo& vote);
-    void onBlockCommitted(const Block& block);
+    void onBlockCommitted(const Block& block, const QuorumCertificate& qc);
     void onConsensusLog(const std::string& message);
     
     // ========================================================================
@@ -88,7 +122,6 @@ private:
     
     void handleConsensusTimer();
     void handleShardMaintenanceTimer();
-    void handleReputationDecayTimer();
     void handleHeartbeatTimer();
     
     // ========================================================================
@@ -105,11 +138,21 @@ private:
     void sendProposal(const ConsensusProposal& proposal);
     void sendVote(const tribft::VoteInfo& vote);
     void sendDecision(const Block& block);
-    void sendPhaseAdvance(const std::string& proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase);
+    void sendPhaseAdvance(MessageID proposalID, ConsensusPhase fromPhase, ConsensusPhase toPhase);
     void sendShardJoinRequest();
     void sendShardUpdate();
     void sendHeartbeat();
     
+    /**
+     * @brief Attach encoded consensus payload and charge its exact size to the frame
+     */
+    void attachPayload(TransactionMessage* msg, const ConsensusCodec::Buffer& payload) const;
+    
+    /**
+     * @brief Copy consensus payload out of a received message
+     */
+    ConsensusCodec::Buffer readPayload(const TransactionMessage* msg) const;
+    
     // ========================================================================
     // UTILITY
     // ========================================================================
@@ -152,6 +195,8 @@ private:
     RegionalShardManager* shardManager_;  // 🔧 Pointer to global module's manager
     std::unique_ptr<HotStuffEngine> consensusEngine_;
     std::unique_ptr<VRMManager> reputationManager_;
+    std::unique_ptr<LightweightSync> lightweightSync_;  // Committed / fetched headers and bodies
+    std::unique_ptr<RangeSync> rangeSync_;              // Catch-up over lightweightSync_
     
     // ========================================================================
     // CONSENSUS GROUP MANAGEMENT (🆕 P1)
@@ -162,6 +207,11 @@ private:
      */
     void electConsensusGroup();
     
+    /**
+     * @brief Every current shard member as a primary node (voter slots without an election)
+     */
+    ConsensusGroup getShardRoster(int epoch) const;
+    
     /**
      * @brief 检查是否需要重新选举
      */
@@ -182,6 +232,8 @@ private:
     // ========================================================================
     
     NodeID nodeID_;
+    NodeIndex nodeIndex_;            // Interned nodeID_ (NodeRegistry)
+    std::shared_ptr<IdGenerator> proposalIDs_;  // Outlives engine rebuilds (handoff)
     ShardID currentShardID_;
     bool isLeaderNode_;
     bool isInitialized_;
@@ -197,7 +249,7 @@ private:
     int txCounter_;
     
     // 🆕 多跳转发相关
-    std::set<std::string> seenTxIds_;  // 已见过的交易ID，防止循环转发
+    DedupFilter seenTxIds_;             // 已见过的交易ID，防止循环转发（有界、按时间窗口淘汰）
     int maxHops_;                       // 最大跳数限制（默认3）
     bool enableMultiHop_;               // 是否启用多跳转发
     
@@ -207,9 +259,9 @@ private:
     
     cMessage* consensusTimer_;
     cMessage* shardMaintenanceTimer_;
-    cMessage* reputationDecayTimer_;
     cMessage* heartbeatTimer_;
     cMessage* txGenerationTimer_;  // 🆕 交易生成定时器
+    cMessage* syncTimer_;          // Catch-up request deadlines
     
     // ========================================================================
     // PARAMETERS (from NED)
@@ -218,13 +270,37 @@ private:
     simtime_t blockInterval_;
     int batchSize_;
     simtime_t consensusTimeout_;
+    int pipelineDepth_;                 // 1 = classic HotStuff, >1 = chained
+    int committedBlockWindow_;          // Committed blocks kept in memory by the engine
+    std::string blockLogPrefix_;        // Per-shard BlockLog file prefix (empty: off)
     bool vrmEnabled_;
     double initialReputation_;
+    bool sharedReputation_;             // One process-wide reputation table + per-node local overlay
+    double reputationWeightLambda_;     // lambda in w = exp(-lambda * N_local)
     
     // 🆕 自动交易生成参数
     bool autoGenerateTx_;
     simtime_t txGenerationInterval_;
     
+    // Shard handoff parameters
+    bool incrementalHandoff_;           // Move membership only, keep consensus engine
+    double handoffHysteresis_;          // Margin beyond shard radius before handoff (m)
+    
+    // Duplicate suppression parameters
+    simtime_t dedupWindow_;             // Minimum time a txID is remembered
+    double dedupFalsePositiveRate_;     // False-positive budget of seenTxIds_
+    int dedupMaxBytes_;                 // Memory cap of seenTxIds_
+    
+    // Catch-up parameters (RangeSync)
+    int catchUpHeaderBatch_;
+    int catchUpBodyBatch_;
+    int catchUpMaxInFlight_;            // Outstanding requests per peer
+    simtime_t catchUpTimeout_;          // First request deadline (doubled per retry)
+    int catchUpMaxAttempts_;
+    simtime_t catchUpPeerTimeout_;      // In range this long after last heard
+    bool catchUpFetchBodies_;
+    bool catchUpCheckpoints_;           // Skip ahead with checkpoint proofs (SkipChain)
+    
     // ========================================================================
     // STATISTICS SIGNALS
     // ========================================================================
@@ -234,6 +310,10 @@ private:
     simsignal_t reputationSignal_;
     simsignal_t throughputSignal_;
     simsignal_t shardSizeSignal_;
+    simsignal_t catchUpTimeSignal_;
+    simsignal_t catchUpBlocksSignal_;
+    simsignal_t catchUpRetriesSignal_;
+    simsignal_t catchUpFailedSignal_;
 };
 
 Define_Module(TriBFTApp);
@@ -0,0 +1,81 @@
+#include "BlockCache.h"
+
+namespace tribft {
+
+BlockCache::BlockCache(size_t budget)
+    : budget_(budget), bytes_(0), evictions_(0)
+{
+}
+
+void BlockCache::setBudget(size_t bytes) {
+    budget_ = bytes;
+    evictToBudget();
+}
+
+bool BlockCache::insert(BlockRef block, MerkleTreeRef tree) {
+    BlockHeight height = block->height;
+    auto existing = index_.find(height);
+    if (existing != index_.end()) {
+        erase(existing);
+    }
+
+    size_t bytes = getByteSize(*block) + tree->getByteSize();
+    if (bytes > budget_) {
+        return false;
+    }
+
+    lru_.push_front(Entry{std::move(block), std::move(tree), bytes});
+    index_.emplace(height, lru_.begin());
+    bytes_ += bytes;
+    evictToBudget();
+    return true;
+}
+
+const BlockCache::Entry* BlockCache::find(BlockHeight height) const {
+    auto it = index_.find(height);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return &*it->second;
+}
+
+void BlockCache::pruneBelow(BlockHeight height) {
+    while (!index_.empty() && index_.begin()->first < height) {
+        erase(index_.begin());
+    }
+}
+
+void BlockCache::clear() {
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+size_t BlockCache::getByteSize(const Block& block) {
+    size_t bytes = sizeof(Block) + block.blockHash.size() + block.previousHash.size() +
+                   block.proposer.size() + block.transactions.size() * sizeof(Transaction);
+    for (const auto& tx : block.transactions) {
+        bytes += tx.txID.size() + tx.sender.size() + tx.receiver.size() + tx.data.size();
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+void BlockCache::erase(std::map<BlockHeight, List::iterator>::iterator it) {
+    bytes_ -= it->second->bytes;
+    lru_.erase(it->second);
+    index_.erase(it);
+}
+
+void BlockCache::evictToBudget() {
+    while (bytes_ > budget_ && !lru_.empty()) {
+        erase(index_.find(lru_.back().block->height));
+        ++evictions_;
+    }
+}
+
+} // namespace tribft
@@ -0,0 +1,87 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <list>
+#include <map>
+#include "../common/TriBFTDefs.h"
+#include "BlockStore.h"
+
+namespace tribft {
+
+/**
+ * @brief Byte-budgeted LRU cache of full blocks (with their Merkle trees)
+ *
+ * Each entry is charged its measured footprint (see getByteSize); the least
+ * recently used blocks are evicted while the total exceeds the budget. A
+ * block larger than the whole budget is not cached.
+ *
+ * Bodies and trees are BlockStore handles shared with other nodes; an
+ * entry is still charged the full footprint, so the budget bounds what a
+ * node would hold on its own.
+ *
+ * The index is ordered by height, so pruneBelow() touches only the blocks
+ * it removes.
+ */
+class BlockCache {
+public:
+    struct Entry {
+        BlockRef block;
+        MerkleTreeRef tree;
+        size_t bytes;
+    };
+
+    static constexpr size_t DEFAULT_BUDGET = 4 * 1024 * 1024;
+
+    explicit BlockCache(size_t budget = DEFAULT_BUDGET);
+
+    /**
+     * @brief Change budget (evicts immediately if over)
+     */
+    void setBudget(size_t bytes);
+
+    /**
+     * @brief Add or replace a block
+     * @return false if the block alone exceeds the budget (not cached)
+     */
+    bool insert(BlockRef block, MerkleTreeRef tree);
+
+    /**
+     * @brief Get entry and mark it most recently used (nullptr if absent)
+     */
+    const Entry* find(BlockHeight height) const;
+
+    bool contains(BlockHeight height) const { return index_.count(height) > 0; }
+
+    /**
+     * @brief Drop all blocks below height
+     */
+    void pruneBelow(BlockHeight height);
+
+    void clear();
+
+    size_t size() const { return index_.size(); }
+    size_t getBytes() const { return bytes_; }
+    size_t getBudget() const { return budget_; }
+    uint64_t getEvictions() const { return evictions_; }
+
+    /**
+     * @brief Footprint of a block: object, strings and transactions
+     */
+    static size_t getByteSize(const Block& block);
+
+private:
+    using List = std::list<Entry>;
+
+    void erase(std::map<BlockHeight, List::iterator>::iterator it);
+    void evictToBudget();
+
+    mutable List lru_;  // Front = most recently used
+    std::map<BlockHeight, List::iterator> index_;
+    size_t budget_;
+    size_t bytes_;
+    uint64_t evictions_;
+};
+
+} // namespace tribft
+
+#endif // BLOCK_CACHE_H
@@ -0,0 +1,651 @@
+#include "BlockLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tribft {
+
+namespace {
+    constexpr char kFileMagic[8] = {'T', 'B', 'F', 'T', 'B', 'L', 'K', '3'};
+    constexpr char kIndexMagic[8] = {'T', 'B', 'F', 'T', 'I', 'D', 'X', '1'};
+    constexpr uint32_t kRecordMagic = 0x4B4C4254;   // "TBLK"
+    constexpr uint64_t kFileHeaderSize = 16;
+    constexpr uint64_t kRecordHeaderSize = 16;
+    constexpr uint64_t kMinCapacity = 1 << 20;      // First mapping: 1 MiB
+    constexpr size_t kVoterBytes = VoterBitmap().size() / 8;
+
+    void storeLE(uint8_t* out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t loadLE(const uint8_t* in, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // ------------------------------------------------------------------------
+    // Record body: fixed-width little-endian fields, strings as [length:4][bytes].
+    // The block hash comes first so duplicates are detected without decoding.
+    // ------------------------------------------------------------------------
+
+    using Bytes = std::vector<uint8_t>;
+
+    void appendLE(Bytes& out, uint64_t value, int bytes) {
+        size_t end = out.size();
+        out.resize(end + bytes);
+        storeLE(out.data() + end, value, bytes);
+    }
+
+    void appendDouble(Bytes& out, double value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendLE(out, bits, 8);
+    }
+
+    void appendString(Bytes& out, const std::string& value) {
+        appendLE(out, value.size(), 4);
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void encodeBody(const Block& block, Bytes& out) {
+        out.clear();
+        appendString(out, block.blockHash);
+        appendString(out, block.previousHash);
+        appendLE(out, static_cast<uint32_t>(block.shardID), 4);
+        appendDouble(out, block.timestamp.dbl());
+        appendString(out, block.proposer);
+        appendLE(out, block.transactions.size(), 4);
+        for (const Transaction& tx : block.transactions) {
+            appendString(out, tx.txID);
+            appendString(out, tx.sender);
+            appendString(out, tx.receiver);
+            appendDouble(out, tx.value);
+            appendDouble(out, tx.timestamp.dbl());
+            appendString(out, tx.data);
+        }
+
+        const QuorumCertificate& qc = block.qc;
+        appendLE(out, qc.proposalID, 8);
+        appendLE(out, static_cast<uint8_t>(qc.phase), 1);
+        appendLE(out, qc.blockHeight, 8);
+        appendLE(out, qc.viewNumber, 8);
+        appendLE(out, static_cast<uint32_t>(qc.totalVotes), 4);
+        appendLE(out, static_cast<uint32_t>(qc.epoch), 4);
+        uint8_t voters[kVoterBytes] = {};
+        for (size_t slot = 0; slot < qc.voters.size(); ++slot) {
+            if (qc.voters.test(slot)) {
+                voters[slot / 8] |= static_cast<uint8_t>(1u << (slot % 8));
+            }
+        }
+        out.insert(out.end(), voters, voters + sizeof(voters));
+        out.insert(out.end(), qc.signature.begin(), qc.signature.end());
+        appendDouble(out, qc.timestamp.dbl());
+    }
+
+    /**
+     * @brief Bounds-checked cursor over a record body
+     */
+    class BodyReader {
+    public:
+        BodyReader(const uint8_t* data, uint32_t length) : data_(data), length_(length), pos_(0) {}
+
+        bool readLE(uint64_t& value, int bytes) {
+            if (length_ - pos_ < static_cast<uint32_t>(bytes)) {
+                return false;
+            }
+            value = loadLE(data_ + pos_, bytes);
+            pos_ += bytes;
+            return true;
+        }
+
+        bool readDouble(double& value) {
+            uint64_t bits = 0;
+            if (!readLE(bits, 8)) {
+                return false;
+            }
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        }
+
+        bool readString(std::string& value) {
+            uint64_t size = 0;
+            if (!readLE(size, 4) || size > length_ - pos_) {
+                return false;
+            }
+            value.assign(reinterpret_cast<const char*>(data_ + pos_), size);
+            pos_ += static_cast<uint32_t>(size);
+            return true;
+        }
+
+        bool readBytes(uint8_t* out, uint32_t size) {
+            if (length_ - pos_ < size) {
+                return false;
+            }
+            std::memcpy(out, data_ + pos_, size);
+            pos_ += size;
+            return true;
+        }
+
+        bool atEnd() const { return pos_ == length_; }
+
+    private:
+        const uint8_t* data_;
+        uint32_t length_;
+        uint32_t pos_;
+    };
+
+    bool decodeBody(const uint8_t* data, uint32_t length, Block& block) {
+        BodyReader reader(data, length);
+        uint64_t shard = 0;
+        double timestamp = 0.0;
+        uint64_t txCount = 0;
+        if (!reader.readString(block.blockHash) ||
+            !reader.readString(block.previousHash) ||
+            !reader.readLE(shard, 4) ||
+            !reader.readDouble(timestamp) ||
+            !reader.readString(block.proposer) ||
+            !reader.readLE(txCount, 4)) {
+            return false;
+        }
+        block.shardID = static_cast<ShardID>(static_cast<int32_t>(shard));
+        block.timestamp = timestamp;
+
+        block.transactions.clear();
+        for (uint64_t i = 0; i < txCount; ++i) {
+            Transaction tx;
+            double txTime = 0.0;
+            if (!reader.readString(tx.txID) ||
+                !reader.readString(tx.sender) ||
+                !reader.readString(tx.receiver) ||
+                !reader.readDouble(tx.value) ||
+                !reader.readDouble(txTime) ||
+                !reader.readString(tx.data)) {
+                return false;
+            }
+            tx.timestamp = txTime;
+            block.transactions.push_back(std::move(tx));
+        }
+
+        QuorumCertificate& qc = block.qc;
+        uint64_t phase = 0;
+        uint64_t totalVotes = 0;
+        uint64_t epoch = 0;
+        uint8_t voters[kVoterBytes] = {};
+        double qcTime = 0.0;
+        if (!reader.readLE(qc.proposalID, 8) ||
+            !reader.readLE(phase, 1) ||
+            !reader.readLE(qc.blockHeight, 8) ||
+            !reader.readLE(qc.viewNumber, 8) ||
+            !reader.readLE(totalVotes, 4) ||
+            !reader.readLE(epoch, 4) ||
+            !reader.readBytes(voters, sizeof(voters)) ||
+            !reader.readBytes(qc.signature.data(), qc.signature.size()) ||
+            !reader.readDouble(qcTime) ||
+            !reader.atEnd() ||
+            phase > static_cast<uint64_t>(ConsensusPhase::COMMIT) || totalVotes > qc.voters.size()) {
+            return false;
+        }
+        qc.phase = static_cast<ConsensusPhase>(phase);
+        qc.totalVotes = static_cast<int>(totalVotes);
+        qc.epoch = static_cast<int32_t>(epoch);
+        qc.voters.reset();
+        for (size_t slot = 0; slot < qc.voters.size(); ++slot) {
+            if (voters[slot / 8] & (1u << (slot % 8))) {
+                qc.voters.set(slot);
+            }
+        }
+        qc.timestamp = qcTime;
+        return true;
+    }
+
+    /**
+     * @brief Block hash of a record body without decoding the rest
+     */
+    bool peekBlockHash(const uint8_t* data, uint32_t length, std::string& blockHash) {
+        BodyReader reader(data, length);
+        return reader.readString(blockHash);
+    }
+
+    /**
+     * @brief Parse the record at offset (false at the end of the valid records)
+     */
+    bool parseRecord(const uint8_t* base, uint64_t size, uint64_t offset, BlockLog::Record& record) {
+        if (size < kRecordHeaderSize || offset > size - kRecordHeaderSize ||
+            loadLE(base + offset, 4) != kRecordMagic) {
+            return false;
+        }
+        uint64_t length = loadLE(base + offset + 4, 4);
+        if (length > size - offset - kRecordHeaderSize) {
+            return false;
+        }
+        record.height = loadLE(base + offset + 8, 8);
+        record.offset = offset;
+        record.body = base + offset + kRecordHeaderSize;
+        record.length = static_cast<uint32_t>(length);
+        return true;
+    }
+
+    bool checkFileHeader(const uint8_t* base, uint64_t size, ShardID& shardID) {
+        if (size < kFileHeaderSize || std::memcmp(base, kFileMagic, sizeof(kFileMagic)) != 0) {
+            return false;
+        }
+        shardID = static_cast<ShardID>(static_cast<int32_t>(loadLE(base + 8, 4)));
+        return true;
+    }
+
+    /**
+     * @brief Read-only mapping of a whole file (scan)
+     */
+    class ReadOnlyMapping {
+    public:
+        explicit ReadOnlyMapping(const std::string& path) {
+#ifdef _WIN32
+            file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+                return;
+            }
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_) {
+                data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+                size_ = data_ ? static_cast<uint64_t>(size.QuadPart) : 0;
+            }
+#else
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd_ < 0 || fstat(fd_, &info) != 0 || info.st_size == 0) {
+                return;
+            }
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+            if (data != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(data);
+                size_ = static_cast<uint64_t>(info.st_size);
+                madvise(data, static_cast<size_t>(size_), MADV_SEQUENTIAL);
+            }
+#endif
+        }
+
+        ~ReadOnlyMapping() {
+#ifdef _WIN32
+            if (data_) {
+                UnmapViewOfFile(data_);
+            }
+            if (mapping_) {
+                CloseHandle(mapping_);
+            }
+            if (file_ != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_);
+            }
+#else
+            if (data_) {
+                munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+#endif
+        }
+
+        ReadOnlyMapping(const ReadOnlyMapping&) = delete;
+        ReadOnlyMapping& operator=(const ReadOnlyMapping&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        uint64_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        uint64_t size_ = 0;
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+    };
+}
+
+BlockLog::BlockLog()
+    : shardID_(-1)
+    , mapping_(nullptr)
+    , capacity_(0)
+    , used_(0)
+    , blockCount_(0)
+#ifdef _WIN32
+    , file_(INVALID_HANDLE_VALUE)
+    , fileMapping_(nullptr)
+#else
+    , fd_(-1)
+#endif
+{
+}
+
+BlockLog::~BlockLog() {
+    close();
+}
+
+// ============================================================================
+// Open / close
+// ============================================================================
+
+bool BlockLog::open(const std::string& path, ShardID shardID) {
+    close();
+
+    // Reject a foreign file before mapping it (mapping grows the file)
+    FILE* existing = std::fopen(path.c_str(), "rb");
+    if (existing) {
+        uint8_t header[kFileHeaderSize];
+        size_t headerBytes = std::fread(header, 1, sizeof(header), existing);
+        std::fclose(existing);
+        ShardID fileShard = -1;
+        if (headerBytes > 0 && (!checkFileHeader(header, headerBytes, fileShard) || fileShard != shardID)) {
+            return false;
+        }
+    }
+
+    path_ = path;
+    shardID_ = shardID;
+
+    uint64_t fileSize = 0;
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                        OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size)) {
+        close();
+        return false;
+    }
+    fileSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd_ < 0 || fstat(fd_, &info) != 0) {
+        close();
+        return false;
+    }
+    fileSize = static_cast<uint64_t>(info.st_size);
+#endif
+
+    if (!map(std::max(fileSize, kMinCapacity))) {
+        close();
+        return false;
+    }
+
+    if (fileSize == 0) {
+        std::memcpy(mapping_, kFileMagic, sizeof(kFileMagic));
+        storeLE(mapping_ + 8, static_cast<uint32_t>(shardID), 4);
+        storeLE(mapping_ + 12, 0, 4);
+        used_ = kFileHeaderSize;
+        return true;
+    }
+
+    rebuildIndex(fileSize);
+    return true;
+}
+
+void BlockLog::close() {
+    // Trim and index only a log that was opened (never truncate a file open() rejected)
+    bool opened = mapping_ != nullptr;
+    if (opened) {
+        writeIndex();
+    }
+    unmap();
+
+#ifdef _WIN32
+    if (file_ != INVALID_HANDLE_VALUE) {
+        if (opened) {
+            LARGE_INTEGER size;
+            size.QuadPart = static_cast<LONGLONG>(used_);
+            SetFilePointerEx(file_, size, nullptr, FILE_BEGIN);
+            SetEndOfFile(file_);
+        }
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ >= 0) {
+        if (opened && ftruncate(fd_, static_cast<off_t>(used_)) != 0) {
+            std::perror("BlockLog: ftruncate");
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+
+    capacity_ = 0;
+    used_ = 0;
+    offsets_.clear();
+    blockCount_ = 0;
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+BlockLog::AppendResult BlockLog::append(const Block& block) {
+    if (!mapping_) {
+        return AppendResult::FAILED;
+    }
+
+    // Shard members commit the same block: compare hashes before encoding anything
+    if (contains(block.height)) {
+        Record record;
+        std::string loggedHash;
+        parseRecord(mapping_, used_, offsets_[block.height], record);
+        if (peekBlockHash(record.body, record.length, loggedHash) &&
+            loggedHash == block.blockHash) {
+            return AppendResult::DUPLICATE;
+        }
+        return AppendResult::CONFLICT;
+    }
+
+    std::vector<uint8_t> body;
+    encodeBody(block, body);
+    if (body.size() > UINT32_MAX || !reserve(used_ + kRecordHeaderSize + body.size())) {
+        return AppendResult::FAILED;
+    }
+
+    uint8_t* out = mapping_ + used_;
+    storeLE(out, kRecordMagic, 4);
+    storeLE(out + 4, body.size(), 4);
+    storeLE(out + 8, block.height, 8);
+    std::memcpy(out + kRecordHeaderSize, body.data(), body.size());
+
+    if (block.height >= offsets_.size()) {
+        offsets_.resize(block.height + 1, 0);
+    }
+    offsets_[block.height] = used_;
+    used_ += kRecordHeaderSize + body.size();
+    ++blockCount_;
+    return AppendResult::APPENDED;
+}
+
+bool BlockLog::read(BlockHeight height, Block& block) const {
+    Record record;
+    return contains(height) &&
+           parseRecord(mapping_, used_, offsets_[height], record) &&
+           decode(record, block);
+}
+
+bool BlockLog::decode(const Record& record, Block& block) {
+    // The height lives in the record header only
+    block.height = record.height;
+    return decodeBody(record.body, record.length, block);
+}
+
+bool BlockLog::scan(const std::string& path, const RecordVisitor& visitor) {
+    ReadOnlyMapping file(path);
+    ShardID shardID = -1;
+    if (!file.data() || !checkFileHeader(file.data(), file.size(), shardID)) {
+        return false;
+    }
+
+    Record record;
+    for (uint64_t offset = kFileHeaderSize; parseRecord(file.data(), file.size(), offset, record);
+         offset += kRecordHeaderSize + record.length) {
+        if (!visitor(record)) {
+            break;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Process-wide shard logs
+// ============================================================================
+
+std::map<std::string, std::unique_ptr<BlockLog>>& BlockLog::getShardLogs() {
+    static std::map<std::string, std::unique_ptr<BlockLog>> logs;
+    return logs;
+}
+
+BlockLog* BlockLog::getShardLog(const std::string& prefix, ShardID shardID) {
+    if (prefix.empty()) {
+        return nullptr;
+    }
+
+    std::string path = prefix + "-shard" + std::to_string(shardID) + ".blk";
+    auto& logs = getShardLogs();
+    auto it = logs.find(path);
+    if (it == logs.end()) {
+        // A rerun replaces its logs (like .sca/.vec); the result directory may not exist yet
+        std::error_code error;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, error);
+        }
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(path + ".idx", error);
+
+        std::unique_ptr<BlockLog> log(new BlockLog());
+        if (!log->open(path, shardID)) {
+            log.reset();
+        }
+        // A failed open is remembered too, so it is not retried on every commit
+        it = logs.emplace(path, std::move(log)).first;
+    }
+    return it->second.get();
+}
+
+void BlockLog::closeAll() {
+    getShardLogs().clear();
+}
+
+// ============================================================================
+// Internal Methods
+// ============================================================================
+
+bool BlockLog::reserve(uint64_t bytes) {
+    if (bytes <= capacity_) {
+        return true;
+    }
+    uint64_t capacity = std::max(capacity_, kMinCapacity);
+    while (capacity < bytes) {
+        capacity *= 2;
+    }
+    unmap();
+    return map(capacity);
+}
+
+bool BlockLog::map(uint64_t capacity) {
+#ifdef _WIN32
+    // Mapping a handle larger than the file extends the file
+    fileMapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(capacity >> 32),
+                                      static_cast<DWORD>(capacity), nullptr);
+    if (!fileMapping_) {
+        return false;
+    }
+    void* mapping = MapViewOfFile(fileMapping_, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(capacity));
+    if (!mapping) {
+        CloseHandle(fileMapping_);
+        fileMapping_ = nullptr;
+        return false;
+    }
+#else
+    struct stat info;
+    if (fstat(fd_, &info) != 0 ||
+        (static_cast<uint64_t>(info.st_size) < capacity && ftruncate(fd_, static_cast<off_t>(capacity)) != 0)) {
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+#endif
+    mapping_ = static_cast<uint8_t*>(mapping);
+    capacity_ = capacity;
+    return true;
+}
+
+void BlockLog::unmap() {
+    if (!mapping_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+    CloseHandle(fileMapping_);
+    fileMapping_ = nullptr;
+#else
+    munmap(mapping_, static_cast<size_t>(capacity_));
+#endif
+    mapping_ = nullptr;
+}
+
+void BlockLog::rebuildIndex(uint64_t fileSize) {
+    offsets_.clear();
+    blockCount_ = 0;
+
+    Record record;
+    uint64_t offset = kFileHeaderSize;
+    for (; parseRecord(mapping_, fileSize, offset, record); offset += kRecordHeaderSize + record.length) {
+        if (record.height >= offsets_.size()) {
+            offsets_.resize(record.height + 1, 0);
+        }
+        if (offsets_[record.height] == 0) {
+            offsets_[record.height] = offset;
+            ++blockCount_;
+        }
+    }
+    used_ = offset;   // Anything after the last complete record is overwritten
+}
+
+void BlockLog::writeIndex() const {
+    FILE* file = std::fopen((path_ + ".idx").c_str(), "wb");
+    if (!file) {
+        return;
+    }
+
+    uint8_t header[16];
+    std::memcpy(header, kIndexMagic, sizeof(kIndexMagic));
+    storeLE(header + 8, static_cast<uint32_t>(shardID_), 4);
+    storeLE(header + 12, blockCount_, 4);
+    std::fwrite(header, 1, sizeof(header), file);
+
+    uint8_t entry[16];
+    for (BlockHeight height = 0; height < offsets_.size(); ++height) {
+        if (offsets_[height] != 0) {
+            storeLE(entry, height, 8);
+            storeLE(entry + 8, offsets_[height], 8);
+            std::fwrite(entry, 1, sizeof(entry), file);
+        }
+    }
+    std::fclose(file);
+}
+
+} // namespace tribft
@@ -0,0 +1,160 @@
+#ifndef BLOCK_LOG_H
+#define BLOCK_LOG_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "../common/TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Append-only, memory-mapped log of committed blocks (one per shard)
+ *
+ * File layout (integers little-endian):
+ *
+ *   header  [magic "TBFTBLK3":8][shardID:4][reserved:4]
+ *   record  [magic 0x4B4C4254:4][length:4][height:8][body:length]
+ *
+ *   body    [blockHash][previousHash][shardID:4][timestamp:8][proposer]
+ *           [txCount:4] then per transaction [txID][sender][receiver][value:8][timestamp:8][data]
+ *           then the QC [proposalID:8][phase:1][blockHeight:8][viewNumber:8]
+ *           [totalVotes:4][epoch:4][voters:32][signature:48][timestamp:8]
+ *
+ * Strings are [length:4][bytes] and doubles their IEEE-754 bits. The
+ * format is the log's own (not the wire codec), so it only changes with
+ * the file magic.
+ * The file grows in doubling chunks and is mapped read-write, so an
+ * append is a memcpy into the mapping. close() trims the unused tail and
+ * writes the height index next to the log ("<path>.idx"):
+ *
+ *   index   [magic "TBFTIDX1":8][shardID:4][count:4] then count x [height:8][offset:8]
+ *
+ * A log that was not closed (crash, killed run) ends in zeros; scan()
+ * and open() stop at the first record whose magic does not match, so
+ * every fully written record is still readable.
+ *
+ * Each height is stored once: every member of a shard commits the same
+ * blocks, and the first append wins (a different hash is a conflict).
+ * Post-run tools read the log with scan() without an OMNeT++ kernel.
+ */
+class BlockLog {
+public:
+    /**
+     * @brief One raw record inside a mapped log (valid while the mapping lives)
+     */
+    struct Record {
+        BlockHeight height;
+        uint64_t offset;           // Of the record header in the file
+        const uint8_t* body;
+        uint32_t length;
+    };
+
+    using RecordVisitor = std::function<bool(const Record&)>;   // Return false to stop
+
+    enum class AppendResult : uint8_t {
+        APPENDED = 0,
+        DUPLICATE = 1,             // Height already logged with the same hash
+        CONFLICT = 2,              // Height already logged with another hash
+        FAILED = 3                 // Log closed or I/O error
+    };
+
+    BlockLog();
+    ~BlockLog();
+
+    BlockLog(const BlockLog&) = delete;
+    BlockLog& operator=(const BlockLog&) = delete;
+
+    /**
+     * @brief Create the log, or reopen it and rebuild the index by scanning
+     * @return false if the file cannot be mapped or belongs to another shard
+     */
+    bool open(const std::string& path, ShardID shardID);
+
+    /**
+     * @brief Trim the file to its records, write the index and unmap
+     */
+    void close();
+
+    bool isOpen() const { return mapping_ != nullptr; }
+    const std::string& getPath() const { return path_; }
+
+    AppendResult append(const Block& block);
+
+    bool contains(BlockHeight height) const {
+        return height < offsets_.size() && offsets_[height] != 0;
+    }
+
+    /**
+     * @brief Decode the block at height from the mapping
+     */
+    bool read(BlockHeight height, Block& block) const;
+
+    size_t getBlockCount() const { return blockCount_; }
+    BlockHeight getLatestHeight() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    uint64_t getBytes() const { return used_; }
+
+    /**
+     * @brief Visit every complete record of a log file in file order (read-only mapping)
+     * @return false if the file cannot be opened or has no valid header
+     */
+    static bool scan(const std::string& path, const RecordVisitor& visitor);
+
+    static bool decode(const Record& record, Block& block);
+
+    // ========================================================================
+    // Process-wide shard logs
+    // ========================================================================
+
+    /**
+     * @brief Shared log of shardID at "<prefix>-shard<ID>.blk"
+     * 
+     * Created on first use in a run, replacing a log left by an earlier run.
+     * A failed open is remembered; the caller decides how to report it.
+     * @return nullptr if prefix is empty or the file cannot be opened
+     */
+    static BlockLog* getShardLog(const std::string& prefix, ShardID shardID);
+
+    /**
+     * @brief Close every shard log (end of run; later calls are no-ops)
+     */
+    static void closeAll();
+
+private:
+    /**
+     * @brief Grow the file and mapping to hold at least bytes
+     */
+    bool reserve(uint64_t bytes);
+
+    bool map(uint64_t capacity);
+    void unmap();
+
+    /**
+     * @brief Rebuild offsets_ from the records in the mapping
+     */
+    void rebuildIndex(uint64_t fileSize);
+
+    void writeIndex() const;
+
+    std::string path_;
+    ShardID shardID_;
+    uint8_t* mapping_;
+    uint64_t capacity_;            // Mapped (and file) size
+    uint64_t used_;                // End of the last record
+    std::vector<uint64_t> offsets_;   // By height, 0 = not logged
+    size_t blockCount_;
+
+#ifdef _WIN32
+    void* file_;
+    void* fileMapping_;
+#else
+    int fd_;
+#endif
+
+    static std::map<std::string, std::unique_ptr<BlockLog>>& getShardLogs();
+};
+
+} // namespace tribft
+
+#endif // BLOCK_LOG_H
@@ -0,0 +1,100 @@
+#include "BlockStore.h"
+#include <algorithm>
+
+namespace tribft {
+
+BlockStore& BlockStore::getGlobalInstance() {
+    static BlockStore store;
+    return store;
+}
+
+BlockRef BlockStore::intern(const Block& block) {
+    auto it = slots_.find(block.blockHash);
+    if (it != slots_.end()) {
+        if (BlockRef body = match(it->second, block)) {
+            return body;
+        }
+    }
+    return insert(std::make_shared<const Block>(block));
+}
+
+BlockRef BlockStore::intern(Block&& block) {
+    auto it = slots_.find(block.blockHash);
+    if (it != slots_.end()) {
+        if (BlockRef body = match(it->second, block)) {
+            return body;
+        }
+    }
+    return insert(std::make_shared<const Block>(std::move(block)));
+}
+
+BlockRef BlockStore::find(const std::string& blockHash) const {
+    auto it = slots_.find(blockHash);
+    return it != slots_.end() ? it->second.block.lock() : nullptr;
+}
+
+MerkleTreeRef BlockStore::getMerkleTree(const BlockRef& block) {
+    auto it = slots_.find(block->blockHash);
+    if (it == slots_.end() || it->second.block.lock() != block) {
+        // Private copy (hash conflict): its tree is not shared either
+        return std::make_shared<const MerkleTree>(block->transactions);
+    }
+
+    MerkleTreeRef tree = it->second.tree.lock();
+    if (!tree) {
+        tree = std::make_shared<const MerkleTree>(block->transactions);
+        it->second.tree = tree;
+    }
+    return tree;
+}
+
+size_t BlockStore::size() {
+    purgeAt_ = 0;
+    purgeExpired();
+    return slots_.size();
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+BlockRef BlockStore::match(const Slot& slot, const Block& block) {
+    BlockRef body = slot.block.lock();
+    if (!body) {
+        return nullptr;
+    }
+    if (body->height != block.height || body->previousHash != block.previousHash ||
+        body->shardID != block.shardID || body->transactions.size() != block.transactions.size()) {
+        ++conflicts_;
+        return nullptr;
+    }
+    ++shared_;
+    return body;
+}
+
+BlockRef BlockStore::insert(BlockRef body) {
+    Slot& slot = slots_[body->blockHash];
+    if (!slot.block.expired()) {
+        return body;
+    }
+    slot.block = body;
+    slot.tree.reset();
+    purgeExpired();
+    return body;
+}
+
+void BlockStore::purgeExpired() {
+    if (slots_.size() < purgeAt_) {
+        return;
+    }
+    for (auto it = slots_.begin(); it != slots_.end();) {
+        if (it->second.block.expired()) {
+            it = slots_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    purgeAt_ = std::max(kMinPurge, 2 * slots_.size());
+}
+
+} // namespace tribft
@@ -0,0 +1,94 @@
+#ifndef BLOCK_STORE_H
+#define BLOCK_STORE_H
+
+#include <memory>
+#include <unordered_map>
+#include "../common/TriBFTDefs.h"
+#include "MerkleTree.h"
+
+namespace tribft {
+
+using BlockRef = std::shared_ptr<const Block>;
+using MerkleTreeRef = std::shared_ptr<const MerkleTree>;
+
+/**
+ * @brief Process-wide content-addressed store of immutable block bodies
+ *
+ * Every member of a shard commits (and caches) the same blocks. Instead of
+ * each node deep-copying the transactions, nodes hold BlockRef handles to
+ * one body per block hash; the body is freed with its last handle (the
+ * store itself only keeps weak references).
+ *
+ * A body is immutable once interned, so it should hold only what every
+ * member agrees on: committers intern it without their QC (HotStuffEngine
+ * keeps QC and commit time per node). A block whose hash is
+ * taken by a live body with different contents (height, parent, shard or
+ * transaction count) is not shared: the caller gets a private copy.
+ *
+ * The Merkle tree over a body's transactions is shared the same way.
+ */
+class BlockStore {
+public:
+    /**
+     * @brief Get global shared instance (all nodes in simulation use this)
+     */
+    static BlockStore& getGlobalInstance();
+
+    /**
+     * @brief Shared body for block (copied only if no matching body is live)
+     */
+    BlockRef intern(const Block& block);
+    BlockRef intern(Block&& block);
+
+    /**
+     * @brief Live body with hash (nullptr if none)
+     */
+    BlockRef find(const std::string& blockHash) const;
+
+    /**
+     * @brief Merkle tree of block's transactions, built once per shared body
+     */
+    MerkleTreeRef getMerkleTree(const BlockRef& block);
+
+    /**
+     * @brief Number of live bodies (expired slots purged)
+     */
+    size_t size();
+
+    uint64_t getSharedCount() const { return shared_; }     // intern() calls answered with a live body
+    uint64_t getConflictCount() const { return conflicts_; }
+
+private:
+    BlockStore() : purgeAt_(kMinPurge), shared_(0), conflicts_(0) {}
+
+    struct Slot {
+        std::weak_ptr<const Block> block;
+        std::weak_ptr<const MerkleTree> tree;
+    };
+
+    static constexpr size_t kMinPurge = 1024;
+
+    /**
+     * @brief Live body of the slot if block could share it, else nullptr
+     */
+    BlockRef match(const Slot& slot, const Block& block);
+
+    /**
+     * @brief Register a new body (or hand out a private copy on conflict)
+     */
+    BlockRef insert(BlockRef body);
+
+    /**
+     * @brief Drop slots whose body expired, once their number doubles
+     */
+    void purgeExpired();
+
+    std::unordered_map<std::string, Slot> slots_;
+    size_t purgeAt_;
+    uint64_t shared_;
+    uint64_t conflicts_;
+};
+
+} // namespace tribft
+
+#endif // BLOCK_STORE_H
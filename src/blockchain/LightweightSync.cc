@@ -1,19 +1,22 @@
 #include "LightweightSync.h"
-#include <sstream>
+#include <algorithm>
 
 namespace tribft {
 
 LightweightSync::LightweightSync()
     : nodeRole_(NodeRole::ORDINARY)
+    , shardID_(-1)
+    , headerBase_(0)
+    , headerBytes_(0)
     , latestHeight_(0)
 {
 }
 
-void LightweightSync::initialize(NodeRole role) {
+void LightweightSync::initialize(NodeRole role, NodeIndex localNode) {
     nodeRole_ = role;
-    latestHeight_ = 0;
-    headers_.clear();
-    fullBlocks_.clear();
+    requestIDs_.reset(localNode);
+    clear();
+    checkpoints_.clear();
     
     std::string roleStr;
     switch (role) {
@@ -34,6 +37,25 @@ void LightweightSync::setRequestCallback(RequestCallback callback) {
     requestCallback_ = callback;
 }
 
+void LightweightSync::setFullBlockBudget(size_t bytes) {
+    fullBlocks_.setBudget(bytes);
+}
+
+void LightweightSync::clear() {
+    clearHeaders();
+    fullBlocks_.clear();
+}
+
+void LightweightSync::setShard(ShardID shardID) {
+    if (shardID == shardID_) {
+        return;
+    }
+    shardID_ = shardID;
+    clear();
+    checkpoints_.clear();
+    log("Following shard " + std::to_string(shardID));
+}
+
 // ============================================================================
 // Block Header Management
 // ============================================================================
@@ -45,8 +67,22 @@ bool LightweightSync::syncHeader(const BlockHeader& header) {
         return false;
     }
     
-    // Store block header
-    headers_[header.height] = header;
+    // Store block header (first, appended, or replacing one in the window)
+    if (headers_.empty()) {
+        headerBase_ = header.height;
+    }
+    if (header.height == headerBase_ + headers_.size()) {
+        headers_.push_back(header);
+    } else if (header.height >= headerBase_ && header.height < headerBase_ + headers_.size()) {
+        BlockHeader& slot = headers_[header.height - headerBase_];
+        headerBytes_ -= getHeaderBytes(slot);
+        slot = header;
+    } else {
+        log("Header " + std::to_string(header.height) + " outside window [" +
+            std::to_string(headerBase_) + ", " + std::to_string(headerBase_ + headers_.size()) + ")");
+        return false;
+    }
+    headerBytes_ += getHeaderBytes(header);
     
     // Update latest height
     if (header.height > latestHeight_) {
@@ -61,27 +97,70 @@ bool LightweightSync::syncHeader(const BlockHeader& header) {
 }
 
 const BlockHeader* LightweightSync::getHeader(BlockHeight height) const {
-    auto it = headers_.find(height);
-    if (it != headers_.end()) {
-        return &(it->second);
+    if (!hasHeader(height)) {
+        return nullptr;
     }
-    return nullptr;
+    return &headers_[height - headerBase_];
 }
 
 bool LightweightSync::hasHeader(BlockHeight height) const {
-    return headers_.find(height) != headers_.end();
+    return height >= headerBase_ && height - headerBase_ < headers_.size();
+}
+
+// ============================================================================
+// Checkpoints
+// ============================================================================
+
+bool LightweightSync::syncCheckpoint(const BlockHeader& header, const QuorumCertificate& qc) {
+    if (!SkipChain::isCheckpointHeight(header.height) || !checkpoints_.append(header, qc)) {
+        return false;
+    }
+    
+    log(">>>CHECKPOINT<<< Height: " + std::to_string(header.height) +
+        ", Links: " + std::to_string(SkipChain::getLinkHeights(header.height).size()) +
+        ", Votes: " + std::to_string(qc.totalVotes));
+    return true;
+}
+
+bool LightweightSync::getCheckpointProof(BlockHeight trustedHeight, BlockHeight targetHeight,
+                                         std::vector<CheckpointHeader>& path) const {
+    return checkpoints_.prove(trustedHeight, targetHeight, path);
+}
+
+bool LightweightSync::adoptCheckpoints(BlockHeight trustedHeight, const std::vector<CheckpointHeader>& path,
+                                       int quorumSize) {
+    const CheckpointHeader* trusted = checkpoints_.find(trustedHeight);
+    bool ownShard = std::all_of(path.begin(), path.end(), [this](const CheckpointHeader& checkpoint) {
+        return shardID_ == -1 || checkpoint.shardID == shardID_;
+    });
+    if (!trusted || path.empty() || !ownShard || !SkipChain::verify(*trusted, path, quorumSize)) {
+        log("Checkpoint proof from height " + std::to_string(trustedHeight) + " rejected");
+        return false;
+    }
+    checkpoints_.adopt(path);
+    
+    // Anchor the header window at the proven tip
+    const CheckpointHeader& tip = path.front();
+    if (tip.height > latestHeight_ || headers_.empty()) {
+        clearHeaders();
+        syncHeader(tip.toHeader());
+    }
+    
+    log(">>>CHECKPOINT_PROOF<<< Height: " + std::to_string(trustedHeight) + " -> " +
+        std::to_string(tip.height) + ", Checkpoints: " + std::to_string(path.size()));
+    return true;
 }
 
 // ============================================================================
 // Full Block Management
 // ============================================================================
 
-std::string LightweightSync::requestFullBlock(BlockHeight height) {
-    std::string requestID = generateRequestID(height);
+MessageID LightweightSync::requestFullBlock(BlockHeight height) {
+    MessageID requestID = requestIDs_.next();
     pendingRequests_[requestID] = height;
     
     log(">>>FULL_BLOCK_REQUEST<<< Height: " + std::to_string(height) +
-        ", RequestID: " + requestID);
+        ", RequestID: " + IdGenerator::toString(requestID));
     
     // Trigger callback (upper layer sends network request)
     if (requestCallback_) {
@@ -106,21 +185,26 @@ bool LightweightSync::receiveFullBlock(const Block& block) {
         return false;
     }
     
-    // Verify Merkle root
-    std::string merkleRoot = BlockHeader::calculateMerkleRoot(block.transactions);
-    if (header->merkleRoot != merkleRoot) {
-        log("Merkle root mismatch at height " + std::to_string(block.height));
-        return false;
-    }
-    
     // Verify transaction count
     if (header->txCount != static_cast<int>(block.transactions.size())) {
         log("Transaction count mismatch at height " + std::to_string(block.height));
         return false;
     }
     
-    // Store full block
-    fullBlocks_[block.height] = block;
+    // Verify Merkle root (tree is kept for serving proofs); body and tree
+    // are shared with every node that holds the same block
+    BlockStore& store = BlockStore::getGlobalInstance();
+    BlockRef body = store.intern(block);
+    MerkleTreeRef tree = store.getMerkleTree(body);
+    if (header->merkleRoot != tree->getRoot()) {
+        log("Merkle root mismatch at height " + std::to_string(block.height));
+        return false;
+    }
+    
+    // Store full block (verified even if too large for the cache)
+    if (!fullBlocks_.insert(std::move(body), std::move(tree))) {
+        log("Full block at height " + std::to_string(block.height) + " exceeds cache budget, not stored");
+    }
     
     log(">>>FULL_BLOCK_RECEIVED<<< Height: " + std::to_string(block.height) +
         ", TxCount: " + std::to_string(block.transactions.size()) +
@@ -130,15 +214,12 @@ bool LightweightSync::receiveFullBlock(const Block& block) {
 }
 
 bool LightweightSync::hasFullBlock(BlockHeight height) const {
-    return fullBlocks_.find(height) != fullBlocks_.end();
+    return fullBlocks_.contains(height);
 }
 
 const Block* LightweightSync::getFullBlock(BlockHeight height) const {
-    auto it = fullBlocks_.find(height);
-    if (it != fullBlocks_.end()) {
-        return &(it->second);
-    }
-    return nullptr;
+    const BlockCache::Entry* entry = fullBlocks_.find(height);
+    return entry ? entry->block.get() : nullptr;
 }
 
 // ============================================================================
@@ -147,31 +228,48 @@ const Block* LightweightSync::getFullBlock(BlockHeight height) const {
 
 bool LightweightSync::verifyTransaction(
     BlockHeight height,
-    const std::string& txHash,
+    const Hash256& txHash,
     const MerkleProof& proof) const
 {
     // Get block header
     const BlockHeader* header = getHeader(height);
-    if (!header) {
+    if (!header || static_cast<int>(proof.leafCount) != header->txCount) {
         return false;
     }
     
-    // Simplified Merkle verification
-    // In production, full Merkle tree verification should be implemented
-    std::string computedRoot = txHash;
-    
-    for (size_t i = 0; i < proof.siblings.size(); ++i) {
-        std::hash<std::string> hasher;
-        if (proof.directions[i]) {
-            // Sibling on left
-            computedRoot = std::to_string(hasher(proof.siblings[i] + computedRoot));
-        } else {
-            // Sibling on right
-            computedRoot = std::to_string(hasher(computedRoot + proof.siblings[i]));
-        }
+    return MerkleTree::verify(header->merkleRoot, txHash, proof);
+}
+
+bool LightweightSync::verifyTransactions(
+    BlockHeight height,
+    const std::vector<Hash256>& txHashes,
+    const MerkleMultiProof& proof) const
+{
+    const BlockHeader* header = getHeader(height);
+    if (!header || static_cast<int>(proof.leafCount) != header->txCount) {
+        return false;
     }
     
-    return (computedRoot == header->merkleRoot);
+    return MerkleTree::verifyBatch(header->merkleRoot, txHashes, proof);
+}
+
+bool LightweightSync::getTransactionProof(BlockHeight height, uint32_t txIndex, MerkleProof& proof) const {
+    const BlockCache::Entry* entry = fullBlocks_.find(height);
+    if (!entry || txIndex >= entry->tree->getLeafCount()) {
+        return false;
+    }
+    proof = entry->tree->prove(txIndex);
+    return true;
+}
+
+bool LightweightSync::getTransactionProofs(BlockHeight height, const std::vector<uint32_t>& txIndices,
+                                           MerkleMultiProof& proof) const {
+    const BlockCache::Entry* entry = fullBlocks_.find(height);
+    if (!entry) {
+        return false;
+    }
+    proof = entry->tree->proveBatch(txIndices);
+    return !proof.leafIndices.empty();
 }
 
 // ============================================================================
@@ -182,14 +280,13 @@ LightweightSync::StorageStats LightweightSync::getStorageStats() const {
     StorageStats stats;
     stats.headerCount = headers_.size();
     stats.fullBlockCount = fullBlocks_.size();
+    stats.checkpointCount = checkpoints_.size();
     
-    // Estimate storage size
-    stats.headerStorage = headers_.size() * 200;  // Assume 200 bytes per header
-    
-    stats.fullBlockStorage = 0;
-    for (const auto& pair : fullBlocks_) {
-        stats.fullBlockStorage += pair.second.transactions.size() * 500;  // Assume 500 bytes per tx
-    }
+    // Running totals kept on every insert / replace / prune
+    stats.headerStorage = headerBytes_;
+    stats.fullBlockStorage = fullBlocks_.getBytes();
+    stats.fullBlockBudget = fullBlocks_.getBudget();
+    stats.fullBlockEvictions = fullBlocks_.getEvictions();
     
     // Calculate compression ratio
     if (stats.headerStorage + stats.fullBlockStorage > 0) {
@@ -209,25 +306,18 @@ void LightweightSync::cleanup(int keepCount) {
     
     BlockHeight cutoff = latestHeight_ - keepCount;
     
-    // Cleanup old block headers
-    auto it = headers_.begin();
-    while (it != headers_.end()) {
-        if (it->first < cutoff) {
-            it = headers_.erase(it);
-        } else {
-            ++it;
+    // Cleanup old block headers (front of the window)
+    if (cutoff > headerBase_) {
+        size_t pruned = std::min<BlockHeight>(cutoff - headerBase_, headers_.size());
+        for (size_t i = 0; i < pruned; ++i) {
+            headerBytes_ -= getHeaderBytes(headers_[i]);
         }
+        headers_.pop_front(pruned);
+        headerBase_ += pruned;
     }
     
     // Cleanup old full blocks
-    auto it2 = fullBlocks_.begin();
-    while (it2 != fullBlocks_.end()) {
-        if (it2->first < cutoff) {
-            it2 = fullBlocks_.erase(it2);
-        } else {
-            ++it2;
-        }
-    }
+    fullBlocks_.pruneBelow(cutoff);
     
     log("Cleanup complete. Kept last " + std::to_string(keepCount) + " blocks");
 }
@@ -237,6 +327,12 @@ void LightweightSync::cleanup(int keepCount) {
 // ============================================================================
 
 bool LightweightSync::validateHeaderChain(const BlockHeader& header) const {
+    // Another shard's chain never extends (or starts) this one
+    if (shardID_ != -1 && header.shardID != shardID_) {
+        log("Header " + std::to_string(header.height) + " belongs to shard " + std::to_string(header.shardID));
+        return false;
+    }
+    
     // Genesis block
     if (header.height == 0) {
         return true;
@@ -268,10 +364,16 @@ bool LightweightSync::validateHeaderChain(const BlockHeader& header) const {
     return true;
 }
 
-std::string LightweightSync::generateRequestID(BlockHeight height) {
-    std::ostringstream oss;
-    oss << "REQ_" << height << "_" << simTime().dbl();
-    return oss.str();
+void LightweightSync::clearHeaders() {
+    latestHeight_ = 0;
+    headers_.clear();
+    headerBase_ = 0;
+    headerBytes_ = 0;
+}
+
+size_t LightweightSync::getHeaderBytes(const BlockHeader& header) {
+    return sizeof(BlockHeader) + header.blockHash.size() + header.previousHash.size() +
+           header.proposer.size();
 }
 
 void LightweightSync::log(const std::string& message) const {
@@ -1,10 +1,15 @@
 #ifndef LIGHTWEIGHT_SYNC_H
 #define LIGHTWEIGHT_SYNC_H
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include "../common/TriBFTDefs.h"
+#include "../common/IdGenerator.h"
+#include "../common/RingBuffer.h"
+#include "MerkleTree.h"
+#include "BlockCache.h"
+#include "SkipChain.h"
 #include "../consensus/VRFSelector.h"  // For NodeRole
 
 namespace tribft {
@@ -16,13 +21,13 @@ struct BlockHeader {
     BlockHeight height;
     std::string blockHash;
     std::string previousHash;
-    std::string merkleRoot;        // Transaction Merkle tree root
+    Hash256 merkleRoot;            // Transaction Merkle tree root (MerkleTree)
     ShardID shardID;
     simtime_t timestamp;
     NodeID proposer;
     int txCount;                   // Transaction count
     
-    BlockHeader() : height(0), shardID(-1), timestamp(0), txCount(0) {}
+    BlockHeader() : height(0), merkleRoot{}, shardID(-1), timestamp(0), txCount(0) {}
     
     /**
      * @brief Extract block header from full block
@@ -41,43 +46,32 @@ struct BlockHeader {
     }
     
     /**
-     * @brief Calculate Merkle root (simplified)
-     */
-    static std::string calculateMerkleRoot(const std::vector<Transaction>& txs) {
-        if (txs.empty()) {
-            return "EMPTY_ROOT";
-        }
-        
-        // Simplified: concatenate all transaction IDs
-        std::string combined;
-        for (const auto& tx : txs) {
-            combined += tx.txID;
-        }
-        
-        std::hash<std::string> hasher;
-        size_t hashValue = hasher(combined);
-        return "MERKLE_" + std::to_string(hashValue);
+     * @brief Calculate Merkle root (builds a throwaway tree)
+     */
+    static Hash256 calculateMerkleRoot(const std::vector<Transaction>& txs) {
+        return MerkleTree(txs).getRoot();
     }
 };
 
-/**
- * @brief Merkle proof (for verifying single transaction)
- */
-struct MerkleProof {
-    std::string txHash;                    // Transaction hash
-    std::vector<std::string> siblings;     // Sibling node hashes
-    std::vector<bool> directions;          // Directions (left=0, right=1)
-    
-    MerkleProof() {}
-};
-
 /**
  * @brief Lightweight sync manager
  * 
  * Features:
  * - Ordinary nodes only sync block headers (reduce storage)
  * - Download full transactions on demand (reduce bandwidth)
- * - Merkle tree verification (ensure security)
+ * - Merkle tree verification (ensure security): each stored full block
+ *   keeps its MerkleTree, so proofs are served without rehashing
+ * 
+ * Storage:
+ * - Headers form one contiguous window [base, base + count) in a ring
+ *   buffer indexed by height - base (O(1) lookup, O(pruned) cleanup).
+ *   A header is accepted at the window end, over an existing height, or
+ *   as the first one; anything else would leave a gap and is rejected.
+ * - Full blocks live in a byte-budgeted LRU cache (BlockCache).
+ * - Every CHECKPOINT_INTERVAL-th committed header is also kept as a
+ *   checkpoint with its QC (SkipChain). Checkpoints survive cleanup, and
+ *   a verified checkpoint proof lets a joining node anchor its header
+ *   window at the proven tip instead of downloading every header.
  * 
  * Design Principles:
  * - KISS: Simplified SPV (Simplified Payment Verification)
@@ -87,7 +81,7 @@ struct MerkleProof {
 class LightweightSync {
 public:
     using LogCallback = std::function<void(const std::string&)>;
-    using RequestCallback = std::function<void(const std::string&, BlockHeight)>;
+    using RequestCallback = std::function<void(MessageID, BlockHeight)>;
     
     LightweightSync();
     ~LightweightSync() = default;
@@ -96,10 +90,33 @@ public:
     // Initialization
     // ========================================================================
     
-    void initialize(NodeRole role);
+    /**
+     * @param localNode Origin node stamped into request IDs
+     */
+    void initialize(NodeRole role, NodeIndex localNode = 0);
     void setLogCallback(LogCallback callback);
     void setRequestCallback(RequestCallback callback);
     
+    /**
+     * @brief Byte budget of the full-block cache (default BlockCache::DEFAULT_BUDGET)
+     */
+    void setFullBlockBudget(size_t bytes);
+    
+    /**
+     * @brief Drop all headers and full blocks (request IDs and checkpoints are kept)
+     */
+    void clear();
+    
+    /**
+     * @brief Follow shardID's chain (-1, the default: accept any shard)
+     * 
+     * A different shard drops the stored headers, full blocks and
+     * checkpoints; headers and checkpoint proofs of other shards are
+     * rejected from then on.
+     */
+    void setShard(ShardID shardID);
+    ShardID getShardID() const { return shardID_; }
+    
     // ========================================================================
     // Block Header Management
     // ========================================================================
@@ -126,6 +143,34 @@ public:
      */
     bool hasHeader(BlockHeight height) const;
     
+    // ========================================================================
+    // Checkpoints (SkipChain)
+    // ========================================================================
+    
+    /**
+     * @brief Record a committed header and its QC as checkpoint
+     * @return false off checkpoint heights, for known heights, or with missing ancestors
+     */
+    bool syncCheckpoint(const BlockHeader& header, const QuorumCertificate& qc);
+    
+    const CheckpointHeader& getLatestCheckpoint() const { return checkpoints_.getLatest(); }
+    
+    /**
+     * @brief Checkpoint path from targetHeight back to trustedHeight (SkipChain::prove)
+     */
+    bool getCheckpointProof(BlockHeight trustedHeight, BlockHeight targetHeight,
+                            std::vector<CheckpointHeader>& path) const;
+    
+    /**
+     * @brief Verify a path against the stored checkpoint at trustedHeight and keep it
+     * 
+     * If the proven tip is above the latest header, the header window
+     * restarts at the tip, so later headers chain onto a QC-certified block.
+     * @return false if trustedHeight is unknown or the path does not verify
+     */
+    bool adoptCheckpoints(BlockHeight trustedHeight, const std::vector<CheckpointHeader>& path,
+                          int quorumSize);
+    
     // ========================================================================
     // Full Block Management (on-demand loading)
     // ========================================================================
@@ -135,7 +180,12 @@ public:
      * @param height Block height
      * @return Request ID
      */
-    std::string requestFullBlock(BlockHeight height);
+    MessageID requestFullBlock(BlockHeight height);
+    
+    /**
+     * @brief Fresh request ID of this node (shared with RangeSync so IDs stay unique)
+     */
+    MessageID newRequestID() { return requestIDs_.next(); }
     
     /**
      * @brief Receive full block
@@ -161,16 +211,38 @@ public:
     /**
      * @brief Verify transaction is in block (using Merkle proof)
      * @param height Block height
-     * @param txHash Transaction hash
+     * @param txHash Leaf hash (MerkleTree::hashLeaf)
      * @param proof Merkle proof
      * @return Verification result
      */
     bool verifyTransaction(
         BlockHeight height,
-        const std::string& txHash,
+        const Hash256& txHash,
         const MerkleProof& proof
     ) const;
     
+    /**
+     * @brief Verify several transactions of one block with a multi-proof
+     * @param txHashes Leaf hashes aligned with proof.leafIndices
+     */
+    bool verifyTransactions(
+        BlockHeight height,
+        const std::vector<Hash256>& txHashes,
+        const MerkleMultiProof& proof
+    ) const;
+    
+    /**
+     * @brief Build proof for transaction txIndex of a stored full block
+     * @return false if the block is not stored or the index is out of range
+     */
+    bool getTransactionProof(BlockHeight height, uint32_t txIndex, MerkleProof& proof) const;
+    
+    /**
+     * @brief Build multi-proof for several transactions of a stored full block
+     */
+    bool getTransactionProofs(BlockHeight height, const std::vector<uint32_t>& txIndices,
+                              MerkleMultiProof& proof) const;
+    
     // ========================================================================
     // Statistics
     // ========================================================================
@@ -181,8 +253,11 @@ public:
     struct StorageStats {
         int headerCount;
         int fullBlockCount;
-        size_t headerStorage;      // bytes
-        size_t fullBlockStorage;   // bytes
+        int checkpointCount;
+        size_t headerStorage;      // bytes (measured, see getHeaderBytes)
+        size_t fullBlockStorage;   // bytes (measured, incl. Merkle trees)
+        size_t fullBlockBudget;    // bytes
+        uint64_t fullBlockEvictions;
         double compressionRatio;   // compression ratio
     };
     
@@ -203,10 +278,16 @@ private:
      */
     bool validateHeaderChain(const BlockHeader& header) const;
     
+    
+    /**
+     * @brief Drop all headers
+     */
+    void clearHeaders();
+    
     /**
-     * @brief Generate request ID
+     * @brief Footprint of a stored header: object plus string contents
      */
-    std::string generateRequestID(BlockHeight height);
+    static size_t getHeaderBytes(const BlockHeader& header);
     
     /**
      * @brief Log output
@@ -218,16 +299,23 @@ private:
     // ========================================================================
     
     NodeRole nodeRole_;
+    ShardID shardID_;                 // Chain followed (-1: any)
     
-    // Block header storage (all nodes)
-    std::map<BlockHeight, BlockHeader> headers_;
+    // Block header storage (all nodes): headers_[i] has height headerBase_ + i
+    RingBuffer<BlockHeader> headers_;
+    BlockHeight headerBase_;
+    size_t headerBytes_;
     BlockHeight latestHeight_;
     
     // Full block storage (on-demand, limited nodes only)
-    std::map<BlockHeight, Block> fullBlocks_;
+    BlockCache fullBlocks_;
+    
+    // Checkpoint spine (all nodes, never pruned)
+    SkipChain checkpoints_;
     
     // Request tracking
-    std::map<std::string, BlockHeight> pendingRequests_;
+    IdGenerator requestIDs_;
+    std::unordered_map<MessageID, BlockHeight> pendingRequests_;
     
     LogCallback logCallback_;
     RequestCallback requestCallback_;
@@ -0,0 +1,205 @@
+#include "MerkleTree.h"
+#include <algorithm>
+
+namespace tribft {
+
+namespace {
+    constexpr uint8_t kLeafPrefix = 0x00;
+    constexpr uint8_t kNodePrefix = 0x01;
+}
+
+MerkleTree::MerkleTree(const std::vector<Transaction>& transactions) {
+    build(transactions);
+}
+
+void MerkleTree::build(const std::vector<Transaction>& transactions) {
+    std::vector<Hash256> leaves;
+    leaves.reserve(transactions.size());
+    for (const auto& tx : transactions) {
+        leaves.push_back(hashLeaf(tx));
+    }
+    build(std::move(leaves));
+}
+
+void MerkleTree::build(std::vector<Hash256> leaves) {
+    levels_.clear();
+    if (leaves.empty()) {
+        return;
+    }
+    
+    levels_.push_back(std::move(leaves));
+    while (levels_.back().size() > 1) {
+        const std::vector<Hash256>& below = levels_.back();
+        std::vector<Hash256> level;
+        level.reserve((below.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < below.size(); i += 2) {
+            level.push_back(hashNode(below[i], below[i + 1]));
+        }
+        if (below.size() % 2 == 1) {
+            level.push_back(below.back());
+        }
+        levels_.push_back(std::move(level));
+    }
+}
+
+const Hash256& MerkleTree::getRoot() const {
+    static const Hash256 empty = emptyRoot();
+    return levels_.empty() ? empty : levels_.back()[0];
+}
+
+size_t MerkleTree::getByteSize() const {
+    size_t bytes = sizeof(MerkleTree);
+    for (const auto& level : levels_) {
+        bytes += sizeof(level) + level.size() * sizeof(Hash256);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Proofs
+// ============================================================================
+
+MerkleProof MerkleTree::prove(uint32_t index) const {
+    MerkleProof proof;
+    proof.leafIndex = index;
+    proof.leafCount = static_cast<uint32_t>(getLeafCount());
+    
+    for (size_t l = 0; l + 1 < levels_.size(); ++l, index >>= 1) {
+        uint32_t sibling = index ^ 1;
+        if (sibling < levels_[l].size()) {
+            proof.siblings.push_back(levels_[l][sibling]);
+        }
+    }
+    return proof;
+}
+
+MerkleMultiProof MerkleTree::proveBatch(std::vector<uint32_t> indices) const {
+    MerkleMultiProof proof;
+    proof.leafCount = static_cast<uint32_t>(getLeafCount());
+    
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    indices.erase(std::lower_bound(indices.begin(), indices.end(), proof.leafCount), indices.end());
+    proof.leafIndices = indices;
+    
+    // Mirror verifyBatch: walk known nodes upwards, emit each missing sibling
+    std::vector<uint32_t> known = std::move(indices);
+    for (size_t l = 0; l + 1 < levels_.size(); ++l) {
+        const uint32_t width = static_cast<uint32_t>(levels_[l].size());
+        std::vector<uint32_t> parents;
+        parents.reserve(known.size());
+        for (size_t j = 0; j < known.size(); ++j) {
+            uint32_t i = known[j];
+            if (i % 2 == 0) {
+                if (j + 1 < known.size() && known[j + 1] == i + 1) {
+                    ++j;
+                } else if (i + 1 < width) {
+                    proof.hashes.push_back(levels_[l][i + 1]);
+                }
+            } else {
+                proof.hashes.push_back(levels_[l][i - 1]);
+            }
+            parents.push_back(i >> 1);
+        }
+        known.swap(parents);
+    }
+    return proof;
+}
+
+// ============================================================================
+// Hashing and Verification
+// ============================================================================
+
+Hash256 MerkleTree::hashLeaf(const Transaction& tx) {
+    Sha256 sha;
+    sha.update(kLeafPrefix);
+    sha.update(tx.txID);
+    return sha.finish();
+}
+
+Hash256 MerkleTree::hashNode(const Hash256& left, const Hash256& right) {
+    Sha256 sha;
+    sha.update(kNodePrefix);
+    sha.update(left);
+    sha.update(right);
+    return sha.finish();
+}
+
+Hash256 MerkleTree::emptyRoot() {
+    return Sha256::digest(nullptr, 0);
+}
+
+bool MerkleTree::verify(const Hash256& root, const Hash256& leaf, const MerkleProof& proof) {
+    if (proof.leafIndex >= proof.leafCount) {
+        return false;
+    }
+    
+    Hash256 hash = leaf;
+    uint32_t index = proof.leafIndex;
+    size_t next = 0;
+    for (uint32_t width = proof.leafCount; width > 1; width = (width + 1) / 2, index >>= 1) {
+        if (index % 2 == 1) {
+            if (next == proof.siblings.size()) {
+                return false;
+            }
+            hash = hashNode(proof.siblings[next++], hash);
+        } else if (index + 1 < width) {
+            if (next == proof.siblings.size()) {
+                return false;
+            }
+            hash = hashNode(hash, proof.siblings[next++]);
+        }
+    }
+    return next == proof.siblings.size() && hash == root;
+}
+
+bool MerkleTree::verifyBatch(const Hash256& root, const std::vector<Hash256>& leaves,
+                             const MerkleMultiProof& proof) {
+    const std::vector<uint32_t>& indices = proof.leafIndices;
+    if (indices.empty() || indices.size() != leaves.size()) {
+        return false;
+    }
+    for (size_t j = 0; j < indices.size(); ++j) {
+        if (indices[j] >= proof.leafCount || (j > 0 && indices[j] <= indices[j - 1])) {
+            return false;
+        }
+    }
+    
+    std::vector<std::pair<uint32_t, Hash256>> nodes;
+    nodes.reserve(indices.size());
+    for (size_t j = 0; j < indices.size(); ++j) {
+        nodes.emplace_back(indices[j], leaves[j]);
+    }
+    
+    size_t next = 0;
+    for (uint32_t width = proof.leafCount; width > 1; width = (width + 1) / 2) {
+        size_t out = 0;
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            uint32_t i = nodes[j].first;
+            Hash256 parent;
+            if (i % 2 == 0) {
+                if (j + 1 < nodes.size() && nodes[j + 1].first == i + 1) {
+                    parent = hashNode(nodes[j].second, nodes[j + 1].second);
+                    ++j;
+                } else if (i + 1 < width) {
+                    if (next == proof.hashes.size()) {
+                        return false;
+                    }
+                    parent = hashNode(nodes[j].second, proof.hashes[next++]);
+                } else {
+                    parent = nodes[j].second;  // Promoted
+                }
+            } else {
+                if (next == proof.hashes.size()) {
+                    return false;
+                }
+                parent = hashNode(proof.hashes[next++], nodes[j].second);
+            }
+            nodes[out++] = {i >> 1, parent};
+        }
+        nodes.resize(out);
+    }
+    return next == proof.hashes.size() && nodes.size() == 1 && nodes[0].second == root;
+}
+
+} // namespace tribft
@@ -0,0 +1,104 @@
+#ifndef MERKLE_TREE_H
+#define MERKLE_TREE_H
+
+#include <vector>
+#include <cstdint>
+#include "../common/TriBFTDefs.h"
+#include "../common/Sha256.h"
+
+namespace tribft {
+
+/**
+ * @brief Inclusion proof for one leaf
+ * 
+ * Sibling hashes bottom-up; levels where the node has no sibling (last
+ * node of an odd level) contribute nothing, so the sides follow from
+ * leafIndex and leafCount.
+ */
+struct MerkleProof {
+    uint32_t leafIndex;
+    uint32_t leafCount;
+    std::vector<Hash256> siblings;
+    
+    MerkleProof() : leafIndex(0), leafCount(0) {}
+};
+
+/**
+ * @brief Inclusion proof for several leaves of one tree
+ * 
+ * Carries only the hashes that cannot be recomputed from the proven leaves
+ * themselves, level by level in ascending node order.
+ */
+struct MerkleMultiProof {
+    uint32_t leafCount;
+    std::vector<uint32_t> leafIndices;  // Ascending, unique
+    std::vector<Hash256> hashes;
+    
+    MerkleMultiProof() : leafCount(0) {}
+};
+
+/**
+ * @brief Binary SHA-256 Merkle tree over a block's transactions
+ * 
+ * - Leaf = H(0x00 || txID), inner node = H(0x01 || left || right)
+ *   (domain separated as in RFC 6962, so a leaf cannot pose as a node).
+ * - The last node of an odd level is promoted unchanged instead of being
+ *   paired with a copy of itself.
+ * - Empty tree root = H("").
+ * 
+ * All levels are kept, so proofs are O(log n) lookups without rehashing.
+ */
+class MerkleTree {
+public:
+    MerkleTree() = default;
+    explicit MerkleTree(const std::vector<Transaction>& transactions);
+    
+    void build(const std::vector<Transaction>& transactions);
+    void build(std::vector<Hash256> leaves);
+    
+    const Hash256& getRoot() const;
+    size_t getLeafCount() const { return levels_.empty() ? 0 : levels_[0].size(); }
+    const Hash256& getLeaf(size_t index) const { return levels_[0][index]; }
+    
+    /**
+     * @brief Memory held by the tree's hash levels
+     */
+    size_t getByteSize() const;
+    
+    /**
+     * @brief Proof for one leaf (index must be < getLeafCount())
+     */
+    MerkleProof prove(uint32_t index) const;
+    
+    /**
+     * @brief Proof for several leaves (duplicates and out-of-range indices dropped)
+     */
+    MerkleMultiProof proveBatch(std::vector<uint32_t> indices) const;
+    
+    // ========================================================================
+    // Hashing and verification (no tree needed)
+    // ========================================================================
+    
+    static Hash256 hashLeaf(const Transaction& tx);
+    static Hash256 hashNode(const Hash256& left, const Hash256& right);
+    static Hash256 emptyRoot();
+    
+    static bool verify(const Hash256& root, const Hash256& leaf, const MerkleProof& proof);
+    
+    /**
+     * @brief Verify several leaves at once
+     * @param leaves Leaf hashes aligned with proof.leafIndices
+     * 
+     * Shared path nodes are hashed once, so k leaves cost at most
+     * k * log2(n) node hashes and usually far fewer.
+     */
+    static bool verifyBatch(const Hash256& root, const std::vector<Hash256>& leaves,
+                            const MerkleMultiProof& proof);
+    
+private:
+    std::vector<std::vector<Hash256>> levels_;  // levels_[0] = leaves, back() = {root}
+};
+
+} // namespace tribft
+
+#endif // MERKLE_TREE_H
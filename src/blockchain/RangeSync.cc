@@ -0,0 +1,570 @@
+#include "RangeSync.h"
+#include "../common/NodeRegistry.h"
+#include <algorithm>
+#include <tuple>
+
+namespace tribft {
+
+namespace {
+    // Longest retry deadline relative to requestTimeout
+    constexpr int kMaxBackoffShift = 3;
+}
+
+RangeSync::RangeSync(LightweightSync& store)
+    : store_(store)
+    , headerBatch_(16)
+    , bodyBatch_(2)
+    , maxInFlight_(2)
+    , requestTimeout_(0.3)
+    , maxAttempts_(4)
+    , peerTimeout_(3.0)
+    , fetchBodies_(true)
+    , checkpointSync_(false)
+    , quorumSize_(Constants::MIN_QUORUM_SIZE)
+    , active_(false)
+    , target_(0)
+    , checkpointPhase_(false)
+    , nextHeaderHeight_(0)
+    , nextBodyHeight_(0)
+    , bodiesPending_(0)
+{
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void RangeSync::setBatching(uint32_t headerBatch, uint32_t bodyBatch, int maxInFlight) {
+    headerBatch_ = std::min(std::max<uint32_t>(1, headerBatch), MAX_BATCH);
+    bodyBatch_ = std::min(std::max<uint32_t>(1, bodyBatch), MAX_BATCH);
+    maxInFlight_ = std::max(1, maxInFlight);
+}
+
+void RangeSync::setRetryPolicy(simtime_t requestTimeout, int maxAttempts, simtime_t peerTimeout) {
+    requestTimeout_ = requestTimeout;
+    maxAttempts_ = std::max(1, maxAttempts);
+    peerTimeout_ = peerTimeout;
+}
+
+void RangeSync::setCheckpointSync(bool enabled, int quorumSize) {
+    checkpointSync_ = enabled;
+    quorumSize_ = quorumSize;
+}
+
+void RangeSync::setRequestCallback(RequestCallback callback) {
+    requestCallback_ = callback;
+}
+
+void RangeSync::setCompleteCallback(CompleteCallback callback) {
+    completeCallback_ = callback;
+}
+
+void RangeSync::setLogCallback(LogCallback callback) {
+    logCallback_ = callback;
+}
+
+// ============================================================================
+// Peers
+// ============================================================================
+
+void RangeSync::notePeer(NodeIndex peer, BlockHeight height) {
+    if (peer == Constants::INVALID_NODE_INDEX) {
+        return;
+    }
+    PeerState& state = peers_[peer];
+    state.height = height;
+    state.lastHeard = simTime();
+}
+
+size_t RangeSync::getPeerCount() const {
+    simtime_t now = simTime();
+    size_t count = 0;
+    for (const auto& entry : peers_) {
+        if (now - entry.second.lastHeard <= peerTimeout_) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Catch-up
+// ============================================================================
+
+bool RangeSync::start(BlockHeight target, BlockHeight from) {
+    if (active_) {
+        if (target > target_) {
+            log("Catch-up target raised " + std::to_string(target_) + " -> " + std::to_string(target));
+            target_ = target;
+            dispatch();
+            finishIfDone();
+        }
+        return true;
+    }
+
+    // Height 0 is genesis, never fetched
+    stats_ = CatchUpStats();
+    stats_.from = store_.hasHeader(store_.getLatestHeight()) ? store_.getLatestHeight() + 1
+                                                             : std::max<BlockHeight>(from, 1);
+    if (stats_.from > target) {
+        return false;
+    }
+    stats_.target = target;
+    stats_.startTime = simTime();
+
+    active_ = true;
+    target_ = target;
+    nextHeaderHeight_ = stats_.from;
+    nextBodyHeight_ = stats_.from;
+    bodiesPending_ = 0;
+    for (auto& entry : peers_) {
+        entry.second.used = false;
+    }
+
+    // Gap spans a checkpoint: ask for a proof from the newest one held locally
+    BlockHeight trusted = store_.getLatestCheckpoint().height;
+    checkpointPhase_ = checkpointSync_ && trusted < stats_.from &&
+                       target - target % Constants::CHECKPOINT_INTERVAL >= stats_.from;
+    if (checkpointPhase_) {
+        queue_.push_back({RangeKind::CHECKPOINTS, trusted, static_cast<uint32_t>(target - trusted), 1,
+                          Constants::INVALID_NODE_INDEX});
+    }
+
+    log(">>>CATCH_UP_START<<< Heights " + std::to_string(stats_.from) + ".." + std::to_string(target) +
+        ", peers in range: " + std::to_string(getPeerCount()) +
+        (checkpointPhase_ ? ", checkpoint proof from " + std::to_string(trusted) : ""));
+
+    dispatch();
+    finishIfDone();
+    return true;
+}
+
+void RangeSync::abort(const std::string& reason) {
+    if (!active_) {
+        return;
+    }
+    log(">>>CATCH_UP_ABORTED<<< " + reason + " (reached " + std::to_string(getAppliedHeight()) +
+        " of " + std::to_string(target_) + ")");
+    finish(false);
+}
+
+void RangeSync::reset() {
+    if (active_) {
+        log(">>>CATCH_UP_ABORTED<<< shard changed (reached " + std::to_string(getAppliedHeight()) +
+            " of " + std::to_string(target_) + ")");
+    }
+    active_ = false;
+    checkpointPhase_ = false;
+    clearRequests();
+    peers_.clear();
+}
+
+bool RangeSync::onHeaders(MessageID requestID, const std::vector<BlockHeader>& headers) {
+    auto it = inFlight_.find(requestID);
+    if (it == inFlight_.end() || it->second.kind != RangeKind::HEADERS) {
+        return false;
+    }
+    RangeRequest request = it->second;
+    inFlight_.erase(it);
+    releasePeer(request.peer);
+
+    // Keep the consecutive prefix starting at the requested height
+    uint32_t received = 0;
+    BlockHeight applied = getAppliedHeight();
+    for (const BlockHeader& header : headers) {
+        if (received == request.count || header.height != request.first + received) {
+            break;
+        }
+        if (header.height > applied) {
+            buffered_.emplace(header.height, std::make_pair(header, request.peer));
+        }
+        ++received;
+    }
+    if (received < request.count) {
+        requeue(RangeKind::HEADERS, request.first + received, request.count - received,
+                request.attempt, request.peer);
+    }
+
+    applyHeaders();
+    dispatch();
+    finishIfDone();
+    return true;
+}
+
+bool RangeSync::onBlocks(MessageID requestID, const std::vector<Block>& blocks) {
+    auto it = inFlight_.find(requestID);
+    if (it == inFlight_.end() || it->second.kind != RangeKind::BLOCKS) {
+        return false;
+    }
+    RangeRequest request = it->second;
+    inFlight_.erase(it);
+    releasePeer(request.peer);
+
+    // Bit i set once height first + i is stored
+    std::vector<bool> stored(request.count, false);
+    for (const Block& block : blocks) {
+        if (block.height < request.first || block.height - request.first >= request.count) {
+            continue;
+        }
+        size_t offset = block.height - request.first;
+        if (!stored[offset] && store_.receiveFullBlock(block)) {
+            stored[offset] = true;
+            --bodiesPending_;
+        }
+    }
+
+    // Re-queue each missing run
+    for (uint32_t i = 0; i < request.count;) {
+        if (stored[i]) {
+            ++i;
+            continue;
+        }
+        uint32_t runStart = i;
+        while (i < request.count && !stored[i]) {
+            ++i;
+        }
+        requeue(RangeKind::BLOCKS, request.first + runStart, i - runStart, request.attempt, request.peer);
+    }
+
+    dispatch();
+    finishIfDone();
+    return true;
+}
+
+bool RangeSync::onCheckpoints(MessageID requestID, const std::vector<CheckpointHeader>& path) {
+    auto it = inFlight_.find(requestID);
+    if (it == inFlight_.end() || it->second.kind != RangeKind::CHECKPOINTS) {
+        return false;
+    }
+    RangeRequest request = it->second;
+    inFlight_.erase(it);
+    releasePeer(request.peer);
+
+    if (path.empty()) {
+        requeue(request.kind, request.first, request.count, request.attempt, request.peer);
+    } else if (!store_.adoptCheckpoints(request.first, path, quorumSize_)) {
+        ++stats_.rejectedHeaders;
+        ++peers_[request.peer].rejected;
+        log("Rejected checkpoint proof from " + NodeRegistry::getGlobalInstance().getName(request.peer));
+        requeue(request.kind, request.first, request.count, request.attempt, request.peer);
+    } else {
+        // Headers (and bodies) restart after the proven tip
+        BlockHeight tip = path.front().height;
+        checkpointPhase_ = false;
+        if (tip >= nextHeaderHeight_) {
+            stats_.checkpointHeight = tip;
+            nextHeaderHeight_ = tip + 1;
+            nextBodyHeight_ = tip + 1;
+        }
+        log(">>>CHECKPOINT_JUMP<<< Height " + std::to_string(request.first) + " -> " + std::to_string(tip) +
+            " with " + std::to_string(path.size()) + " checkpoints");
+    }
+
+    dispatch();
+    finishIfDone();
+    return true;
+}
+
+void RangeSync::tick() {
+    if (!active_) {
+        return;
+    }
+
+    simtime_t now = simTime();
+    std::vector<RangeRequest> expired;
+    for (const auto& entry : inFlight_) {
+        if (entry.second.deadline <= now) {
+            expired.push_back(entry.second);
+        }
+    }
+    for (const RangeRequest& request : expired) {
+        if (!active_) {
+            break;
+        }
+        inFlight_.erase(request.requestID);
+        releasePeer(request.peer);
+        ++peers_[request.peer].timeouts;
+        log("Request " + IdGenerator::toString(request.requestID) + " timed out (attempt " +
+            std::to_string(request.attempt) + ")");
+        requeue(request.kind, request.first, request.count, request.attempt, request.peer);
+    }
+
+    dispatch();
+    finishIfDone();
+}
+
+simtime_t RangeSync::getNextDeadline() const {
+    simtime_t next = SIMTIME_ZERO;
+    for (const auto& entry : inFlight_) {
+        if (next == SIMTIME_ZERO || entry.second.deadline < next) {
+            next = entry.second.deadline;
+        }
+    }
+    return next;
+}
+
+// ============================================================================
+// Internal Methods
+// ============================================================================
+
+void RangeSync::dispatch() {
+    while (active_) {
+        Range range;
+        bool queued = !queue_.empty();
+        BlockHeight applied = getAppliedHeight();
+        if (queued) {
+            range = queue_.front();
+        } else if (checkpointPhase_) {
+            break;
+        } else if (nextHeaderHeight_ <= target_) {
+            uint32_t count = static_cast<uint32_t>(
+                std::min<BlockHeight>(headerBatch_, target_ - nextHeaderHeight_ + 1));
+            range = {RangeKind::HEADERS, nextHeaderHeight_, count, 1, Constants::INVALID_NODE_INDEX};
+        } else if (fetchBodies_ && nextBodyHeight_ <= applied) {
+            uint32_t count = static_cast<uint32_t>(
+                std::min<BlockHeight>(bodyBatch_, applied - nextBodyHeight_ + 1));
+            range = {RangeKind::BLOCKS, nextBodyHeight_, count, 1, Constants::INVALID_NODE_INDEX};
+        } else {
+            break;
+        }
+
+        NodeIndex peer = pickPeer(range);
+        if (peer == Constants::INVALID_NODE_INDEX) {
+            break;
+        }
+
+        if (queued) {
+            queue_.pop_front();
+        } else if (range.kind == RangeKind::HEADERS) {
+            nextHeaderHeight_ += range.count;
+        } else {
+            nextBodyHeight_ += range.count;
+            bodiesPending_ += static_cast<int>(range.count);
+        }
+        send(range, peer);
+    }
+
+    // Nothing in flight and nobody to ask: waiting would never end
+    if (!active_ || !inFlight_.empty()) {
+        return;
+    }
+    if (checkpointPhase_) {
+        endCheckpointPhase("no peer in range serves checkpoints");
+        return;
+    }
+    if (getAppliedHeight() < target_) {
+        abort("no peer in range can serve the missing heights");
+        return;
+    }
+    if (bodiesPending_ > 0 || (fetchBodies_ && nextBodyHeight_ <= target_)) {
+        // Headers are verified; bodies stay on-demand (LightweightSync::requestFullBlock)
+        int skipped = bodiesPending_ + static_cast<int>(fetchBodies_ && nextBodyHeight_ <= target_
+                                                        ? target_ - nextBodyHeight_ + 1 : 0);
+        stats_.skippedBodies += skipped;
+        log("No peer in range serves bodies, skipping " + std::to_string(skipped));
+        queue_.clear();
+        bodiesPending_ = 0;
+        nextBodyHeight_ = target_ + 1;
+    }
+}
+
+NodeIndex RangeSync::pickPeer(const Range& range) const {
+    simtime_t now = simTime();
+    BlockHeight last = range.first + range.count - 1;
+
+    NodeIndex best = Constants::INVALID_NODE_INDEX;
+    NodeIndex fallback = Constants::INVALID_NODE_INDEX;
+    const PeerState* bestState = nullptr;
+    for (const auto& entry : peers_) {
+        const PeerState& state = entry.second;
+        if (now - state.lastHeard > peerTimeout_ || state.height < last ||
+            state.inFlight >= maxInFlight_ || state.rejected >= maxAttempts_) {
+            continue;
+        }
+        if (entry.first == range.avoid) {
+            fallback = entry.first;
+            continue;
+        }
+        // Least loaded, then fewest timeouts, then least used; index breaks ties
+        if (!bestState ||
+            std::tie(state.inFlight, state.timeouts, state.sent, entry.first) <
+            std::tie(bestState->inFlight, bestState->timeouts, bestState->sent, best)) {
+            best = entry.first;
+            bestState = &state;
+        }
+    }
+    return best != Constants::INVALID_NODE_INDEX ? best : fallback;
+}
+
+void RangeSync::send(const Range& range, NodeIndex peer) {
+    RangeRequest request;
+    request.requestID = store_.newRequestID();
+    request.shardID = store_.getShardID();
+    request.kind = range.kind;
+    request.first = range.first;
+    request.count = range.count;
+    request.peer = peer;
+    request.deadline = simTime() + timeoutFor(range.attempt);
+    request.attempt = range.attempt;
+    inFlight_.emplace(request.requestID, request);
+
+    PeerState& state = peers_[peer];
+    ++state.inFlight;
+    ++state.sent;
+    if (!state.used) {
+        state.used = true;
+        ++stats_.peersUsed;
+    }
+    ++stats_.requests;
+
+    if (requestCallback_) {
+        requestCallback_(request);
+    }
+}
+
+void RangeSync::requeue(RangeKind kind, BlockHeight first, uint32_t count, int attempt, NodeIndex avoid) {
+    if (!active_) {
+        return;
+    }
+    ++stats_.retries;
+    if (attempt < maxAttempts_) {
+        queue_.push_back({kind, first, count, attempt + 1, avoid});
+        return;
+    }
+
+    if (kind == RangeKind::CHECKPOINTS) {
+        endCheckpointPhase("checkpoint proof failed " + std::to_string(attempt) + " attempts");
+        return;
+    }
+    if (kind == RangeKind::BLOCKS) {
+        stats_.skippedBodies += static_cast<int>(count);
+        bodiesPending_ -= static_cast<int>(count);
+        log("Skipping bodies " + std::to_string(first) + ".." + std::to_string(first + count - 1) +
+            " after " + std::to_string(attempt) + " attempts");
+        return;
+    }
+    abort("headers " + std::to_string(first) + ".." + std::to_string(first + count - 1) +
+          " failed " + std::to_string(attempt) + " attempts");
+}
+
+void RangeSync::endCheckpointPhase(const std::string& reason) {
+    if (!checkpointPhase_) {
+        return;
+    }
+    log("No checkpoint proof (" + reason + "), fetching every header");
+    checkpointPhase_ = false;
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(), [](const Range& range) {
+        return range.kind == RangeKind::CHECKPOINTS;
+    }), queue_.end());
+    dispatch();
+}
+
+void RangeSync::releasePeer(NodeIndex peer) {
+    auto it = peers_.find(peer);
+    if (it != peers_.end() && it->second.inFlight > 0) {
+        --it->second.inFlight;
+    }
+}
+
+void RangeSync::applyHeaders() {
+    while (active_ && !buffered_.empty()) {
+        auto it = buffered_.begin();
+        BlockHeight applied = getAppliedHeight();
+        if (it->first <= applied) {
+            buffered_.erase(it);
+            continue;
+        }
+        if (it->first != applied + 1) {
+            break;
+        }
+
+        if (store_.syncHeader(it->second.first)) {
+            buffered_.erase(it);
+            continue;
+        }
+
+        // Does not extend the chain: distrust the rest of this peer's data too
+        NodeIndex peer = it->second.second;
+        ++stats_.rejectedHeaders;
+        ++peers_[peer].rejected;
+        log("Rejected header " + std::to_string(it->first) + " from " +
+            NodeRegistry::getGlobalInstance().getName(peer));
+        dropBuffered(peer);
+    }
+}
+
+void RangeSync::dropBuffered(NodeIndex peer) {
+    std::vector<BlockHeight> heights;
+    for (auto it = buffered_.begin(); it != buffered_.end();) {
+        if (it->second.second == peer) {
+            heights.push_back(it->first);
+            it = buffered_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Re-queue consecutive runs
+    for (size_t i = 0; i < heights.size() && active_;) {
+        size_t runStart = i;
+        while (i + 1 < heights.size() && heights[i + 1] == heights[i] + 1) {
+            ++i;
+        }
+        ++i;
+        requeue(RangeKind::HEADERS, heights[runStart], static_cast<uint32_t>(i - runStart), 1, peer);
+    }
+}
+
+void RangeSync::finishIfDone() {
+    if (!active_ || checkpointPhase_ || getAppliedHeight() < target_) {
+        return;
+    }
+    if (fetchBodies_ && (nextBodyHeight_ <= target_ || bodiesPending_ > 0)) {
+        return;
+    }
+    log(">>>CATCH_UP_COMPLETE<<< Height " + std::to_string(target_) + " in " +
+        std::to_string((simTime() - stats_.startTime).dbl()) + "s (" + std::to_string(stats_.requests) +
+        " requests, " + std::to_string(stats_.retries) + " retries, " + std::to_string(stats_.peersUsed) +
+        " peers)");
+    finish(true);
+}
+
+void RangeSync::finish(bool completed) {
+    active_ = false;
+    checkpointPhase_ = false;
+    stats_.target = target_;
+    stats_.duration = simTime() - stats_.startTime;
+    stats_.completed = completed;
+    clearRequests();
+
+    if (completeCallback_) {
+        completeCallback_(stats_);
+    }
+}
+
+void RangeSync::clearRequests() {
+    for (const auto& entry : inFlight_) {
+        releasePeer(entry.second.peer);
+    }
+    inFlight_.clear();
+    queue_.clear();
+    buffered_.clear();
+    bodiesPending_ = 0;
+}
+
+simtime_t RangeSync::timeoutFor(int attempt) const {
+    return requestTimeout_ * static_cast<double>(1 << std::min(attempt - 1, kMaxBackoffShift));
+}
+
+BlockHeight RangeSync::getAppliedHeight() const {
+    BlockHeight latest = store_.getLatestHeight();
+    return store_.hasHeader(latest) ? latest : stats_.from - 1;
+}
+
+void RangeSync::log(const std::string& message) const {
+    if (logCallback_) {
+        logCallback_("[RangeSync] " + message);
+    }
+}
+
+} // namespace tribft
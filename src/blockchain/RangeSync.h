@@ -0,0 +1,297 @@
+#ifndef RANGE_SYNC_H
+#define RANGE_SYNC_H
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <functional>
+#include "../common/TriBFTDefs.h"
+#include "LightweightSync.h"
+
+namespace tribft {
+
+/**
+ * @brief Parallel multi-peer catch-up for a lagging node
+ *
+ * Pulls the heights (latest stored header, target] into a LightweightSync:
+ * - With checkpoint sync on and a checkpoint height inside the gap, one
+ *   peer is first asked for a checkpoint proof from the newest local
+ *   checkpoint towards target (SkipChain). A verified proof restarts the
+ *   header window at the proven tip, so only the heights after it are
+ *   fetched, and keeps the local checkpoint spine complete enough to
+ *   append later commits. No usable proof falls back to every header.
+ * - The missing range is cut into header ranges of headerBatch heights.
+ *   They are requested from every in-range peer that advertised a high
+ *   enough height, least loaded first, at most maxInFlight per peer.
+ * - Responses arrive in any order. They are buffered and applied in height
+ *   order through LightweightSync::syncHeader, so the header chain is
+ *   validated (validateHeaderChain) as data streams in. A header that
+ *   breaks the chain is dropped together with everything else buffered
+ *   from its sender, and those heights are requested from another peer.
+ * - Every applied header releases its block body for download (bodyBatch
+ *   heights per request, spread over peers the same way). Bodies are
+ *   checked against their headers by LightweightSync::receiveFullBlock.
+ * - Short or empty responses re-queue the missing heights at once. A
+ *   request unanswered before its deadline (timeout doubled per attempt)
+ *   is re-queued as well; retries avoid the peer that failed.
+ * - Headers that run out of attempts, or no peer left to ask, abort the
+ *   catch-up. Bodies that run out of attempts are skipped.
+ *
+ * Peers are in range while heard from within peerTimeout (notePeer).
+ * The owner sends requests (RequestCallback), feeds responses back
+ * (onHeaders / onBlocks) and calls tick() at getNextDeadline().
+ */
+class RangeSync {
+public:
+    using RangeKind = SyncRangeKind;
+
+    /**
+     * @brief One request handed to the owner for sending (wire fields + retry state)
+     */
+    struct RangeRequest : SyncRequest {
+        simtime_t deadline;
+        int attempt;               // 1 for the first send of a range
+        
+        RangeRequest() : deadline(SIMTIME_ZERO), attempt(0) {}
+    };
+
+    /**
+     * @brief Outcome of one catch-up
+     */
+    struct CatchUpStats {
+        BlockHeight from{0};
+        BlockHeight target{0};
+        simtime_t startTime{0};
+        simtime_t duration{0};
+        int requests{0};
+        int retries{0};            // Ranges re-queued (timeout, short response, rejection)
+        int rejectedHeaders{0};    // Failed chain validation
+        int skippedBodies{0};      // Ran out of attempts
+        BlockHeight checkpointHeight{0};  // Proven tip headers restarted from (0: none)
+        int peersUsed{0};
+        bool completed{false};
+    };
+
+    using RequestCallback = std::function<void(const RangeRequest&)>;
+    using CompleteCallback = std::function<void(const CatchUpStats&)>;
+    using LogCallback = std::function<void(const std::string&)>;
+
+    static constexpr uint32_t MAX_BATCH = 64;   // Heights per request (also caps what a server returns)
+
+    explicit RangeSync(LightweightSync& store);
+
+    // ========================================================================
+    // Configuration
+    // ========================================================================
+
+    /**
+     * @param headerBatch Heights per header request (at most MAX_BATCH)
+     * @param bodyBatch Heights per block-body request (at most MAX_BATCH)
+     * @param maxInFlight Outstanding requests per peer
+     */
+    void setBatching(uint32_t headerBatch, uint32_t bodyBatch, int maxInFlight);
+
+    /**
+     * @param requestTimeout Deadline of a first attempt (doubled per retry, up to 8x)
+     * @param maxAttempts Sends per range before giving up on it
+     * @param peerTimeout Time a peer stays in range after it was last heard
+     */
+    void setRetryPolicy(simtime_t requestTimeout, int maxAttempts, simtime_t peerTimeout);
+
+    /**
+     * @brief Also download block bodies (default true)
+     */
+    void setFetchBodies(bool enabled) { fetchBodies_ = enabled; }
+
+    /**
+     * @brief Skip ahead with checkpoint proofs (default off)
+     * @param quorumSize Votes a checkpoint QC needs (SkipChain::verify)
+     */
+    void setCheckpointSync(bool enabled, int quorumSize);
+
+    void setRequestCallback(RequestCallback callback);
+    void setCompleteCallback(CompleteCallback callback);
+    void setLogCallback(LogCallback callback);
+
+    // ========================================================================
+    // Peers
+    // ========================================================================
+
+    /**
+     * @brief Peer heard now, serving headers up to height (latest report wins)
+     */
+    void notePeer(NodeIndex peer, BlockHeight height);
+
+    /**
+     * @brief Peers heard within peerTimeout
+     */
+    size_t getPeerCount() const;
+
+    // ========================================================================
+    // Catch-up
+    // ========================================================================
+
+    /**
+     * @brief Start catching up to target, or raise the target of a running catch-up
+     * @param from First height to fetch if the store holds no header yet
+     * @return false if the store already reaches target
+     */
+    bool start(BlockHeight target, BlockHeight from);
+
+    /**
+     * @brief Abandon the running catch-up (reported as not completed)
+     */
+    void abort(const std::string& reason);
+
+    /**
+     * @brief Drop the running catch-up and every peer without reporting it
+     *
+     * For a node that left its shard: the target chain is no longer its own.
+     */
+    void reset();
+
+    bool isActive() const { return active_; }
+    BlockHeight getTarget() const { return target_; }
+
+    /**
+     * @brief Headers answering requestID (consecutive from the requested first height)
+     * @return false if requestID is not outstanding (late, duplicate or foreign)
+     */
+    bool onHeaders(MessageID requestID, const std::vector<BlockHeader>& headers);
+
+    /**
+     * @brief Block bodies answering requestID (any subset of the requested range)
+     */
+    bool onBlocks(MessageID requestID, const std::vector<Block>& blocks);
+
+    /**
+     * @brief Checkpoint proof answering requestID (empty: peer cannot prove)
+     */
+    bool onCheckpoints(MessageID requestID, const std::vector<CheckpointHeader>& path);
+
+    /**
+     * @brief Re-queue requests past their deadline and send queued ranges
+     */
+    void tick();
+
+    /**
+     * @brief Earliest outstanding deadline (SIMTIME_ZERO if nothing is in flight)
+     */
+    simtime_t getNextDeadline() const;
+
+    size_t getInFlightCount() const { return inFlight_.size(); }
+
+    /**
+     * @brief Stats of the running or last finished catch-up
+     */
+    const CatchUpStats& getStats() const { return stats_; }
+
+private:
+    /**
+     * @brief Heights waiting to be (re)sent
+     */
+    struct Range {
+        RangeKind kind;
+        BlockHeight first;
+        uint32_t count;
+        int attempt;
+        NodeIndex avoid;           // Peer that failed this range last
+    };
+
+    struct PeerState {
+        BlockHeight height{0};
+        simtime_t lastHeard{0};
+        int inFlight{0};
+        int sent{0};
+        int timeouts{0};
+        int rejected{0};           // Invalid headers; excluded at maxAttempts
+        bool used{false};
+    };
+
+    /**
+     * @brief Send queued ranges, then new header ranges, then new body ranges
+     * 
+     * While a checkpoint proof is pending only queued ranges are sent.
+     */
+    void dispatch();
+
+    /**
+     * @brief Least loaded in-range peer able to serve range (INVALID_NODE_INDEX if none)
+     */
+    NodeIndex pickPeer(const Range& range) const;
+
+    void send(const Range& range, NodeIndex peer);
+
+    /**
+     * @brief Queue range again (attempt + 1), or give up on it after maxAttempts
+     */
+    void requeue(RangeKind kind, BlockHeight first, uint32_t count, int attempt, NodeIndex avoid);
+
+    /**
+     * @brief Stop waiting for a checkpoint proof and fetch every header
+     */
+    void endCheckpointPhase(const std::string& reason);
+
+    /**
+     * @brief Release the peer slot of an answered / expired request
+     */
+    void releasePeer(NodeIndex peer);
+
+    /**
+     * @brief Apply buffered headers that extend the stored chain
+     */
+    void applyHeaders();
+
+    /**
+     * @brief Drop buffered headers of peer and re-queue their heights
+     */
+    void dropBuffered(NodeIndex peer);
+
+    void finishIfDone();
+    void finish(bool completed);
+
+    /**
+     * @brief Forget requests, queued ranges and buffered headers
+     */
+    void clearRequests();
+
+    simtime_t timeoutFor(int attempt) const;
+    BlockHeight getAppliedHeight() const;
+    void log(const std::string& message) const;
+
+    LightweightSync& store_;
+
+    // Configuration
+    uint32_t headerBatch_;
+    uint32_t bodyBatch_;
+    int maxInFlight_;
+    simtime_t requestTimeout_;
+    int maxAttempts_;
+    simtime_t peerTimeout_;
+    bool fetchBodies_;
+    bool checkpointSync_;
+    int quorumSize_;
+
+    // Catch-up state
+    bool active_;
+    BlockHeight target_;
+    bool checkpointPhase_;              // Checkpoint proof requested, headers held back
+    BlockHeight nextHeaderHeight_;      // First height never requested as header
+    BlockHeight nextBodyHeight_;        // First applied height whose body was never requested
+    int bodiesPending_;                 // Body heights queued or in flight
+    std::deque<Range> queue_;
+    std::unordered_map<MessageID, RangeRequest> inFlight_;
+    std::map<BlockHeight, std::pair<BlockHeader, NodeIndex>> buffered_;
+    CatchUpStats stats_;
+
+    std::unordered_map<NodeIndex, PeerState> peers_;
+
+    RequestCallback requestCallback_;
+    CompleteCallback completeCallback_;
+    LogCallback logCallback_;
+};
+
+} // namespace tribft
+
+#endif // RANGE_SYNC_H
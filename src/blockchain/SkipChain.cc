@@ -0,0 +1,211 @@
+#include "SkipChain.h"
+#include "LightweightSync.h"
+#include "../common/Sha256.h"
+
+namespace tribft {
+
+namespace {
+    constexpr uint8_t kCheckpointPrefix = 0x02;   // Domain tag (MerkleTree uses 0x00 / 0x01)
+
+    /**
+     * @brief Trailing zero bits of checkpoint index k (k > 0)
+     */
+    int trailingZeros(BlockHeight k) {
+        int zeros = 0;
+        while ((k & 1) == 0) {
+            k >>= 1;
+            ++zeros;
+        }
+        return zeros;
+    }
+
+    void updateFixed64(Sha256& sha, uint64_t value) {
+        uint8_t bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        sha.update(bytes, sizeof(bytes));
+    }
+
+    void updateString(Sha256& sha, const std::string& value) {
+        updateFixed64(sha, value.size());
+        sha.update(value);
+    }
+}
+
+// ============================================================================
+// CheckpointHeader
+// ============================================================================
+
+CheckpointHeader CheckpointHeader::fromHeader(const BlockHeader& header, const QuorumCertificate& qc) {
+    CheckpointHeader checkpoint;
+    checkpoint.height = header.height;
+    checkpoint.blockHash = header.blockHash;
+    checkpoint.previousHash = header.previousHash;
+    checkpoint.merkleRoot = header.merkleRoot;
+    checkpoint.shardID = header.shardID;
+    checkpoint.proposer = header.proposer;
+    checkpoint.txCount = header.txCount;
+    checkpoint.qc = qc;
+    return checkpoint;
+}
+
+BlockHeader CheckpointHeader::toHeader() const {
+    BlockHeader header;
+    header.height = height;
+    header.blockHash = blockHash;
+    header.previousHash = previousHash;
+    header.merkleRoot = merkleRoot;
+    header.shardID = shardID;
+    header.timestamp = qc.timestamp;
+    header.proposer = proposer;
+    header.txCount = txCount;
+    return header;
+}
+
+Hash256 CheckpointHeader::digest() const {
+    Sha256 sha;
+    sha.update(kCheckpointPrefix);
+    updateFixed64(sha, height);
+    updateString(sha, blockHash);
+    updateString(sha, previousHash);
+    sha.update(merkleRoot);
+    updateFixed64(sha, static_cast<uint32_t>(shardID));
+    updateString(sha, proposer);
+    updateFixed64(sha, static_cast<uint32_t>(txCount));
+    updateFixed64(sha, skipLinks.size());
+    for (const Hash256& link : skipLinks) {
+        sha.update(link);
+    }
+    return sha.finish();
+}
+
+// ============================================================================
+// SkipChain
+// ============================================================================
+
+SkipChain::SkipChain() {
+    clear();
+}
+
+std::vector<BlockHeight> SkipChain::getLinkHeights(BlockHeight height) {
+    std::vector<BlockHeight> heights;
+    BlockHeight index = height / Constants::CHECKPOINT_INTERVAL;
+    if (index == 0) {
+        return heights;
+    }
+    int links = trailingZeros(index) + 1;
+    for (int i = 0; i < links; ++i) {
+        heights.push_back(linkTarget(height, i));
+    }
+    return heights;
+}
+
+const CheckpointHeader& SkipChain::getGenesis() {
+    static const CheckpointHeader genesis;
+    return genesis;
+}
+
+void SkipChain::clear() {
+    checkpoints_.clear();
+    checkpoints_.emplace(0, getGenesis());
+}
+
+bool SkipChain::append(const BlockHeader& header, const QuorumCertificate& qc) {
+    if (header.height == 0 || !isCheckpointHeight(header.height) || checkpoints_.count(header.height)) {
+        return false;
+    }
+
+    CheckpointHeader checkpoint = CheckpointHeader::fromHeader(header, qc);
+    for (BlockHeight ancestor : getLinkHeights(header.height)) {
+        auto it = checkpoints_.find(ancestor);
+        if (it == checkpoints_.end()) {
+            return false;
+        }
+        checkpoint.skipLinks.push_back(it->second.digest());
+    }
+    checkpoints_.emplace(header.height, std::move(checkpoint));
+    return true;
+}
+
+void SkipChain::adopt(const std::vector<CheckpointHeader>& path) {
+    for (const CheckpointHeader& checkpoint : path) {
+        checkpoints_.emplace(checkpoint.height, checkpoint);
+    }
+}
+
+const CheckpointHeader* SkipChain::find(BlockHeight height) const {
+    auto it = checkpoints_.find(height);
+    return it != checkpoints_.end() ? &it->second : nullptr;
+}
+
+bool SkipChain::prove(BlockHeight trustedHeight, BlockHeight targetHeight,
+                      std::vector<CheckpointHeader>& path) const {
+    path.clear();
+    if (targetHeight < trustedHeight || !isCheckpointHeight(targetHeight) ||
+        !isCheckpointHeight(trustedHeight) || !find(trustedHeight)) {
+        return false;
+    }
+
+    BlockHeight height = targetHeight;
+    while (height != trustedHeight) {
+        const CheckpointHeader* checkpoint = find(height);
+        if (!checkpoint) {
+            path.clear();
+            return false;
+        }
+        path.push_back(*checkpoint);
+        height = linkTarget(height, chooseLink(height, trustedHeight));
+    }
+    return true;
+}
+
+bool SkipChain::verify(const CheckpointHeader& trusted, const std::vector<CheckpointHeader>& path,
+                       int quorumSize) {
+    for (size_t i = 0; i < path.size(); ++i) {
+        const CheckpointHeader& checkpoint = path[i];
+        const CheckpointHeader& next = i + 1 < path.size() ? path[i + 1] : trusted;
+
+        // Checkpoint height, newer than its successor, committed by a quorum
+        if (!isCheckpointHeight(checkpoint.height) || checkpoint.height <= next.height ||
+            checkpoint.qc.blockHeight != checkpoint.height ||
+            static_cast<int>(checkpoint.qc.voters.count()) != checkpoint.qc.totalVotes ||
+            !checkpoint.qc.isValid(quorumSize)) {
+            return false;
+        }
+
+        std::vector<BlockHeight> links = getLinkHeights(checkpoint.height);
+        if (checkpoint.skipLinks.size() != links.size()) {
+            return false;
+        }
+
+        // One of the links must name the successor by digest
+        size_t link = 0;
+        while (link < links.size() && links[link] != next.height) {
+            ++link;
+        }
+        if (link == links.size() || checkpoint.skipLinks[link] != next.digest()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int SkipChain::chooseLink(BlockHeight height, BlockHeight floorHeight) {
+    BlockHeight index = height / Constants::CHECKPOINT_INTERVAL;
+    if (index == 0 || height <= floorHeight) {
+        return -1;
+    }
+    for (int link = trailingZeros(index); link > 0; --link) {
+        if (linkTarget(height, link) >= floorHeight) {
+            return link;
+        }
+    }
+    return 0;
+}
+
+BlockHeight SkipChain::linkTarget(BlockHeight height, int link) {
+    return height - (Constants::CHECKPOINT_INTERVAL << link);
+}
+
+} // namespace tribft
@@ -0,0 +1,130 @@
+#ifndef SKIP_CHAIN_H
+#define SKIP_CHAIN_H
+
+#include <map>
+#include <vector>
+#include "../common/TriBFTDefs.h"
+
+namespace tribft {
+
+struct BlockHeader;
+
+/**
+ * @brief Checkpoint header: block header, its commit QC and skip links
+ *
+ * Checkpoint k sits at height k * CHECKPOINT_INTERVAL (k = 0 is the genesis
+ * checkpoint every node starts from). It links back to checkpoints
+ * k - 2^i for i = 0..tz(k) (tz = trailing zero bits), so skipLinks[0] is
+ * the previous checkpoint and checkpoint 2^j links down to genesis. A link
+ * is the ancestor's digest(); the digest covers the links, so a path of
+ * checkpoints is hash-chained back to whichever one the verifier trusts.
+ */
+struct CheckpointHeader {
+    BlockHeight height;
+    std::string blockHash;
+    std::string previousHash;
+    Hash256 merkleRoot;
+    ShardID shardID;
+    NodeID proposer;
+    int txCount;
+    QuorumCertificate qc;              // Not covered by digest() (attests the header)
+    std::vector<Hash256> skipLinks;
+
+    CheckpointHeader() : height(0), merkleRoot{}, shardID(-1), txCount(0) {}
+
+    /**
+     * @brief Copy the consensus fields of header (local timestamp is left out)
+     */
+    static CheckpointHeader fromHeader(const BlockHeader& header, const QuorumCertificate& qc);
+
+    /**
+     * @brief Header to anchor a header chain at (timestamp taken from the QC)
+     */
+    BlockHeader toHeader() const;
+
+    /**
+     * @brief SHA-256 over height, hashes, Merkle root, shard, proposer, txCount and skip links
+     */
+    Hash256 digest() const;
+};
+
+/**
+ * @brief Checkpoint store with logarithmic proofs (light-client sync)
+ *
+ * A proof from trusted checkpoint a to target b walks back from b, each
+ * time taking the longest link that does not pass a. A jump of 2^i from
+ * index k lands on an index with at least i trailing zeros, like counting
+ * a binary counter down, so the path has O(log(b - a)) checkpoints instead
+ * of the b - a headers a plain hash chain needs.
+ *
+ * The path to checkpoint c holds exactly the ancestors that checkpoints
+ * after c link to, so a node that adopts a verified path can keep
+ * appending its own checkpoints from there.
+ *
+ * Checkpoints are sparse in height (one per CHECKPOINT_INTERVAL) and are
+ * not pruned with headers: they are the long-lived spine of the chain.
+ */
+class SkipChain {
+public:
+    SkipChain();
+
+    static bool isCheckpointHeight(BlockHeight height) {
+        return height % Constants::CHECKPOINT_INTERVAL == 0;
+    }
+
+    /**
+     * @brief Heights linked by the checkpoint at height, skipLinks order
+     */
+    static std::vector<BlockHeight> getLinkHeights(BlockHeight height);
+
+    static const CheckpointHeader& getGenesis();
+
+    /**
+     * @brief Drop everything but genesis
+     */
+    void clear();
+
+    /**
+     * @brief Create the checkpoint for a committed header (links from stored ancestors)
+     * @return false if not a checkpoint height, already stored, or an ancestor is missing
+     */
+    bool append(const BlockHeader& header, const QuorumCertificate& qc);
+
+    /**
+     * @brief Store the checkpoints of a verified path
+     */
+    void adopt(const std::vector<CheckpointHeader>& path);
+
+    const CheckpointHeader* find(BlockHeight height) const;
+    const CheckpointHeader& getLatest() const { return checkpoints_.rbegin()->second; }
+    size_t size() const { return checkpoints_.size(); }
+
+    /**
+     * @brief Path from target back to trusted: newest first, trusted itself excluded
+     * @return false if either end or a checkpoint on the way is not stored
+     */
+    bool prove(BlockHeight trustedHeight, BlockHeight targetHeight, std::vector<CheckpointHeader>& path) const;
+
+    /**
+     * @brief Check a path against a trusted checkpoint
+     *
+     * path[0] is the target; every element must be linked by the one before
+     * it, the last one must link trusted, and each must carry a QC for its
+     * own height with at least quorumSize votes.
+     */
+    static bool verify(const CheckpointHeader& trusted, const std::vector<CheckpointHeader>& path, int quorumSize);
+
+private:
+    /**
+     * @brief Largest link of height that does not pass floorHeight (-1 if none)
+     */
+    static int chooseLink(BlockHeight height, BlockHeight floorHeight);
+
+    static BlockHeight linkTarget(BlockHeight height, int link);
+
+    std::map<BlockHeight, CheckpointHeader> checkpoints_;
+};
+
+} // namespace tribft
+
+#endif // SKIP_CHAIN_H
@@ -0,0 +1,142 @@
+#include "DedupFilter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tribft {
+
+namespace {
+    constexpr double kDefaultWindow = 30.0;
+    constexpr double kDefaultFalsePositiveRate = 0.001;
+    constexpr size_t kDefaultMaxBytes = 64 * 1024;
+    constexpr int kMaxHashes = 16;
+}
+
+DedupFilter::DedupFilter()
+    : current_(0), window_(SIMTIME_ZERO), words_(0), numBits_(0), hashCount_(1), capacity_(0)
+{
+    configure(kDefaultWindow, kDefaultFalsePositiveRate, kDefaultMaxBytes);
+}
+
+void DedupFilter::configure(simtime_t window, double falsePositiveRate, size_t maxBytes) {
+    window_ = window > SIMTIME_ZERO ? window : simtime_t(kDefaultWindow);
+    if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0)) {
+        falsePositiveRate = kDefaultFalsePositiveRate;
+    }
+
+    // Split memory between the two generations (at least one word each)
+    words_ = std::max<size_t>(1, maxBytes / (2 * sizeof(uint64_t)));
+    numBits_ = words_ * 64;
+
+    // A lookup tests both generations, so each gets half the budget.
+    // Optimal Bloom sizing: k = log2(1/p), n = m * ln2^2 / ln(1/p)
+    const double perGeneration = falsePositiveRate / 2.0;
+    const double ln2 = std::log(2.0);
+    hashCount_ = std::min(kMaxHashes, std::max(1, static_cast<int>(std::ceil(-std::log2(perGeneration)))));
+    capacity_ = std::max<size_t>(1, static_cast<size_t>(numBits_ * ln2 * ln2 / -std::log(perGeneration)));
+
+    for (Generation& gen : generations_) {
+        gen.bits.assign(words_, 0);
+        gen.count = 0;
+        gen.start = SIMTIME_ZERO;
+    }
+    current_ = 0;
+    stats_ = Stats();
+}
+
+bool DedupFilter::testAndInsert(const std::string& key, simtime_t now) {
+    Generation* cur = &generations_[current_];
+    if (now - cur->start >= window_ || cur->count >= capacity_) {
+        rotate(now);
+        cur = &generations_[current_];
+    }
+
+    ++stats_.queries;
+
+    uint64_t h1 = hashKey(key);
+    uint64_t h2 = mix(h1) | 1;  // Odd step visits distinct bits
+
+    if (contains(*cur, h1, h2)) {
+        ++stats_.hits;
+        return true;
+    }
+
+    bool seenBefore = contains(generations_[1 - current_], h1, h2);
+    if (seenBefore) {
+        ++stats_.hits;
+    }
+
+    // Refresh into the current generation so IDs still circulating stay suppressed
+    insert(*cur, h1, h2);
+    return seenBefore;
+}
+
+double DedupFilter::getHitRate() const {
+    return stats_.queries > 0 ? static_cast<double>(stats_.hits) / stats_.queries : 0.0;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void DedupFilter::rotate(simtime_t now) {
+    Generation& cur = generations_[current_];
+    Generation& prev = generations_[1 - current_];
+
+    // Both generations are older than the window: forget everything
+    if (now - cur.start >= window_ * 2) {
+        stats_.evictions += cur.count;
+        std::fill(cur.bits.begin(), cur.bits.end(), 0);
+        cur.count = 0;
+    }
+
+    stats_.evictions += prev.count;
+    std::fill(prev.bits.begin(), prev.bits.end(), 0);
+    prev.count = 0;
+    prev.start = now;
+
+    current_ = 1 - current_;
+    ++stats_.rotations;
+}
+
+bool DedupFilter::contains(const Generation& gen, uint64_t h1, uint64_t h2) const {
+    if (gen.count == 0) {
+        return false;
+    }
+    for (int i = 0; i < hashCount_; ++i) {
+        uint64_t bit = (h1 + i * h2) % numBits_;
+        if ((gen.bits[bit >> 6] & (uint64_t(1) << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DedupFilter::insert(Generation& gen, uint64_t h1, uint64_t h2) {
+    for (int i = 0; i < hashCount_; ++i) {
+        uint64_t bit = (h1 + i * h2) % numBits_;
+        gen.bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+    ++gen.count;
+}
+
+uint64_t DedupFilter::hashKey(const std::string& key) {
+    // FNV-1a 64-bit
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t DedupFilter::mix(uint64_t value) {
+    // splitmix64 finalizer
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+} // namespace tribft
@@ -0,0 +1,83 @@
+#ifndef DEDUP_FILTER_H
+#define DEDUP_FILTER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Bounded, time-windowed duplicate filter for relayed message IDs
+ *
+ * Two Bloom filter generations (current + previous) rotate every window,
+ * so an ID is remembered for at least one window and at most two. Memory
+ * is fixed at construction; if a generation fills up before its window
+ * ends it is rotated early, which keeps the false-positive rate within
+ * budget at the cost of a shorter memory under heavy load.
+ *
+ * A false positive drops a message that was never seen; there are no
+ * false negatives while the ID is within the window.
+ */
+class DedupFilter {
+public:
+    struct Stats {
+        uint64_t queries = 0;     // testAndInsert() calls
+        uint64_t hits = 0;        // Reported as duplicate
+        uint64_t rotations = 0;   // Generation swaps (window or capacity)
+        uint64_t evictions = 0;   // IDs forgotten by rotation
+    };
+
+    DedupFilter();
+
+    /**
+     * @brief Size the filter and drop all entries
+     * @param window Minimum time an ID is remembered
+     * @param falsePositiveRate Budget for both generations together (0, 1)
+     * @param maxBytes Total bit-array memory for both generations
+     */
+    void configure(simtime_t window, double falsePositiveRate, size_t maxBytes);
+
+    /**
+     * @brief Check an ID and record it
+     * @return true if the ID was (probably) seen within the window
+     */
+    bool testAndInsert(const std::string& key, simtime_t now);
+
+    const Stats& getStats() const { return stats_; }
+    double getHitRate() const;
+
+    size_t getCapacity() const { return capacity_; }       // IDs per generation
+    size_t getMemoryBytes() const { return 2 * words_ * sizeof(uint64_t); }
+    int getHashCount() const { return hashCount_; }
+
+private:
+    struct Generation {
+        std::vector<uint64_t> bits;
+        size_t count = 0;
+        simtime_t start = SIMTIME_ZERO;
+    };
+
+    void rotate(simtime_t now);
+    bool contains(const Generation& gen, uint64_t h1, uint64_t h2) const;
+    void insert(Generation& gen, uint64_t h1, uint64_t h2);
+
+    static uint64_t hashKey(const std::string& key);
+    static uint64_t mix(uint64_t value);
+
+    Generation generations_[2];
+    int current_;
+
+    simtime_t window_;
+    size_t words_;         // 64-bit words per generation
+    size_t numBits_;       // Bits per generation
+    int hashCount_;
+    size_t capacity_;
+
+    Stats stats_;
+};
+
+} // namespace tribft
+
+#endif // DEDUP_FILTER_H
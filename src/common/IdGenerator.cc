@@ -0,0 +1,21 @@
+#include "IdGenerator.h"
+#include "NodeRegistry.h"
+
+namespace tribft {
+
+std::string IdGenerator::toString(MessageID id) {
+    if (id == Constants::INVALID_MESSAGE_ID) {
+        return "-";
+    }
+    
+    NodeIndex node = getNode(id);
+    const NodeID& name = NodeRegistry::getGlobalInstance().getName(node);
+    std::string out = name.empty() ? std::to_string(node) : name;
+    out += '#';
+    out += std::to_string(getEpoch(id));
+    out += '.';
+    out += std::to_string(getSequence(id));
+    return out;
+}
+
+} // namespace tribft
@@ -0,0 +1,89 @@
+#ifndef ID_GENERATOR_H
+#define ID_GENERATOR_H
+
+#include <string>
+#include "TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Unique 64-bit message IDs (proposals, sync requests, events)
+ * 
+ * Layout: [node:24][epoch:16][sequence:24]
+ * - node: NodeIndex of the originating node (NodeRegistry)
+ * - sequence: per-generator counter starting at 1
+ * - epoch: bumped whenever sequence wraps
+ * 
+ * IDs are plain integers on the wire and as map keys; toString() renders
+ * them for logs only. 0 is never generated (Constants::INVALID_MESSAGE_ID).
+ */
+class IdGenerator {
+public:
+    static constexpr int SEQUENCE_BITS = 24;
+    static constexpr int EPOCH_BITS = 16;
+    static constexpr int NODE_BITS = 24;
+    
+    explicit IdGenerator(NodeIndex node = 0, uint32_t epoch = 0)
+        : node_(node), epoch_(epoch), sequence_(0) {}
+    
+    /**
+     * @brief Restart for node at epoch (sequence back to 1)
+     */
+    void reset(NodeIndex node, uint32_t epoch = 0) {
+        node_ = node;
+        epoch_ = epoch;
+        sequence_ = 0;
+    }
+    
+    /**
+     * @brief Next ID of the generator's own node
+     */
+    MessageID next() { return nextFor(node_); }
+    
+    /**
+     * @brief Next ID attributed to another origin node (same counter)
+     */
+    MessageID nextFor(NodeIndex node) {
+        if (++sequence_ > SEQUENCE_MASK) {
+            sequence_ = 1;
+            ++epoch_;
+        }
+        return compose(node, epoch_, sequence_);
+    }
+    
+    static MessageID compose(NodeIndex node, uint32_t epoch, uint32_t sequence) {
+        return (static_cast<MessageID>(node & NODE_MASK) << (EPOCH_BITS + SEQUENCE_BITS)) |
+               (static_cast<MessageID>(epoch & EPOCH_MASK) << SEQUENCE_BITS) |
+               (sequence & SEQUENCE_MASK);
+    }
+    
+    static NodeIndex getNode(MessageID id) {
+        return static_cast<NodeIndex>(id >> (EPOCH_BITS + SEQUENCE_BITS));
+    }
+    
+    static uint32_t getEpoch(MessageID id) {
+        return static_cast<uint32_t>(id >> SEQUENCE_BITS) & EPOCH_MASK;
+    }
+    
+    static uint32_t getSequence(MessageID id) {
+        return static_cast<uint32_t>(id) & SEQUENCE_MASK;
+    }
+    
+    /**
+     * @brief Log rendering: "<node name>#<epoch>.<sequence>"
+     */
+    static std::string toString(MessageID id);
+    
+private:
+    static constexpr uint32_t SEQUENCE_MASK = (1u << SEQUENCE_BITS) - 1;
+    static constexpr uint32_t EPOCH_MASK = (1u << EPOCH_BITS) - 1;
+    static constexpr uint32_t NODE_MASK = (1u << NODE_BITS) - 1;
+    
+    NodeIndex node_;
+    uint32_t epoch_;
+    uint32_t sequence_;
+};
+
+} // namespace tribft
+
+#endif // ID_GENERATOR_H
@@ -0,0 +1,88 @@
+#ifndef INTERACTION_WEIGHT_H
+#define INTERACTION_WEIGHT_H
+
+#include <array>
+#include <cmath>
+
+namespace tribft {
+
+/**
+ * @brief Dynamic weight w(N) = exp(-lambda * N) of the dual reputation model
+ *
+ * R_final = w * R_global + (1-w) * R_local, with N the local interaction
+ * count. w(N) is read from a table over N in [0, TABLE_SIZE); the table is
+ * built by a constexpr exp, so the default-lambda instance is computed at
+ * compile time and a custom lambda costs one table build at configuration.
+ * Counts beyond the table fall back to std::exp.
+ */
+class InteractionWeight {
+public:
+    static constexpr int TABLE_SIZE = 256;
+    using Table = std::array<double, TABLE_SIZE>;
+
+    constexpr explicit InteractionWeight(double lambda)
+        : lambda_(lambda), table_(makeTable(lambda)) {}
+
+    /**
+     * @brief w(N) (N <= 0 gives 1)
+     */
+    double operator()(int interactions) const {
+        if (interactions <= 0) {
+            return 1.0;
+        }
+        if (interactions < TABLE_SIZE) {
+            return table_[interactions];
+        }
+        return std::exp(-lambda_ * interactions);
+    }
+
+    constexpr double getLambda() const { return lambda_; }
+
+private:
+    static constexpr Table makeTable(double lambda) {
+        Table table{};
+        for (int n = 0; n < TABLE_SIZE; ++n) {
+            table[n] = expNegative(lambda * n);
+        }
+        return table;
+    }
+
+    /**
+     * @brief exp(-x) for x >= 0: e^-floor(x) by squaring, Taylor series for the rest
+     */
+    static constexpr double expNegative(double x) {
+        if (!(x > 0.0)) {
+            return 1.0;
+        }
+        if (x > 745.0) {
+            return 0.0;  // Below the smallest subnormal
+        }
+
+        long whole = static_cast<long>(x);
+        double frac = x - static_cast<double>(whole);
+
+        double intPart = 1.0;
+        double base = 0.36787944117144233;  // e^-1
+        for (long k = whole; k > 0; k >>= 1) {
+            if (k & 1) {
+                intPart *= base;
+            }
+            base *= base;
+        }
+
+        double term = 1.0;
+        double sum = 1.0;
+        for (int i = 1; i < 30; ++i) {
+            term *= -frac / i;
+            sum += term;
+        }
+        return intPart * sum;
+    }
+
+    double lambda_;
+    Table table_;
+};
+
+} // namespace tribft
+
+#endif // INTERACTION_WEIGHT_H
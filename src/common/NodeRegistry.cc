@@ -0,0 +1,41 @@
+#include "NodeRegistry.h"
+
+namespace tribft {
+
+namespace {
+    const NodeID kUnknownName;
+}
+
+NodeRegistry& NodeRegistry::getGlobalInstance() {
+    static NodeRegistry registry;
+    return registry;
+}
+
+NodeIndex NodeRegistry::intern(const NodeID& name) {
+    auto it = indexByName_.find(name);
+    if (it != indexByName_.end()) {
+        return it->second;
+    }
+    
+    NodeIndex index = static_cast<NodeIndex>(names_.size());
+    names_.push_back(name);
+    indexByName_.emplace(name, index);
+    return index;
+}
+
+NodeIndex NodeRegistry::find(const NodeID& name) const {
+    auto it = indexByName_.find(name);
+    if (it != indexByName_.end()) {
+        return it->second;
+    }
+    return Constants::INVALID_NODE_INDEX;
+}
+
+const NodeID& NodeRegistry::getName(NodeIndex index) const {
+    if (index < names_.size()) {
+        return names_[index];
+    }
+    return kUnknownName;
+}
+
+} // namespace tribft
@@ -0,0 +1,53 @@
+#ifndef NODE_REGISTRY_H
+#define NODE_REGISTRY_H
+
+#include <vector>
+#include <unordered_map>
+#include "TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Process-wide NodeID interning table
+ * 
+ * Maps module full names to dense 32-bit indices (0, 1, 2, ...) in order
+ * of first appearance. Core containers key on NodeIndex and can therefore
+ * be plain vectors; names are only resolved for logging and messages.
+ * 
+ * Indices are never recycled, so an index stays valid for the whole run.
+ */
+class NodeRegistry {
+public:
+    /**
+     * @brief Get global shared instance (all nodes in simulation use this)
+     */
+    static NodeRegistry& getGlobalInstance();
+    
+    /**
+     * @brief Get index for name, assigning the next free one if unknown
+     */
+    NodeIndex intern(const NodeID& name);
+    
+    /**
+     * @brief Get index for name without assigning
+     * @return Index, or Constants::INVALID_NODE_INDEX if never interned
+     */
+    NodeIndex find(const NodeID& name) const;
+    
+    /**
+     * @brief Resolve index back to name (empty string if out of range)
+     */
+    const NodeID& getName(NodeIndex index) const;
+    
+    size_t size() const { return names_.size(); }
+    
+private:
+    NodeRegistry() = default;
+    
+    std::unordered_map<NodeID, NodeIndex> indexByName_;
+    std::vector<NodeID> names_;
+};
+
+} // namespace tribft
+
+#endif // NODE_REGISTRY_H
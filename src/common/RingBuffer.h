@@ -0,0 +1,77 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+namespace tribft {
+
+/**
+ * @brief Growable circular buffer (FIFO with random access)
+ *
+ * Element i is the i-th oldest. push_back() doubles the storage when full,
+ * pop_front() is O(count) and resets the freed slots so they release any
+ * memory they own. Capacity is a power of two, so indexing is a mask.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+    T& operator[](size_t i) { return slots_[(head_ + i) & (slots_.size() - 1)]; }
+    const T& operator[](size_t i) const { return slots_[(head_ + i) & (slots_.size() - 1)]; }
+
+    T& front() { return (*this)[0]; }
+    T& back() { return (*this)[size_ - 1]; }
+
+    void push_back(T value) {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        (*this)[size_] = std::move(value);
+        ++size_;
+    }
+
+    /**
+     * @brief Drop the count oldest elements (clamped to size())
+     */
+    void pop_front(size_t count = 1) {
+        if (count > size_) {
+            count = size_;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            (*this)[i] = T();
+        }
+        if (!slots_.empty()) {
+            head_ = (head_ + count) & (slots_.size() - 1);
+        }
+        size_ -= count;
+    }
+
+    void clear() {
+        slots_.clear();
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    void grow() {
+        std::vector<T> larger(slots_.empty() ? 16 : slots_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            larger[i] = std::move((*this)[i]);
+        }
+        slots_.swap(larger);
+        head_ = 0;
+    }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace tribft
+
+#endif // RING_BUFFER_H
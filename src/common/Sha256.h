@@ -0,0 +1,52 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief SHA-256 (FIPS 180-4), incremental
+ *
+ * Used for Merkle trees; small inputs (one leaf, two child hashes) are
+ * hashed without building a concatenated buffer first.
+ */
+class Sha256 {
+public:
+    Sha256();
+
+    void update(const void* data, size_t length);
+    void update(uint8_t byte) { update(&byte, 1); }
+    void update(const std::string& data) { update(data.data(), data.size()); }
+    void update(const Hash256& hash) { update(hash.data(), hash.size()); }
+
+    /**
+     * @brief Finish and return the digest (object must be reset to reuse)
+     */
+    Hash256 finish();
+
+    void reset();
+
+    static Hash256 digest(const void* data, size_t length);
+    static Hash256 digest(const std::string& data) { return digest(data.data(), data.size()); }
+
+    /**
+     * @brief Lowercase hex rendering (logs)
+     */
+    static std::string toHex(const Hash256& hash);
+
+private:
+    void compress(const uint8_t* block);
+
+    uint32_t state_[8];
+    uint8_t buffer_[64];
+    size_t buffered_;
+    uint64_t length_;   // Total bytes
+};
+
+} // namespace tribft
+
+#endif // SHA256_H
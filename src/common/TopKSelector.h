@@ -0,0 +1,77 @@
+#ifndef TOPK_SELECTOR_H
+#define TOPK_SELECTOR_H
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+
+namespace tribft {
+
+/**
+ * @brief Reusable top-K selection over scored candidates
+ *
+ * The caller fills a row-major score matrix (one row per seed, one column
+ * per candidate) and asks for the best k columns of a row. Selection is
+ * nth_element + sort of the k winners, O(n + k log k) instead of a full
+ * sort, and all buffers are kept between calls so steady-state elections
+ * do not allocate.
+ *
+ * Order: higher score first, ties broken by lower candidate index, so
+ * results are deterministic for a given candidate order.
+ */
+template <typename Score>
+class TopKSelector {
+public:
+    TopKSelector() : candidates_(0), rows_(0) {}
+
+    /**
+     * @brief Size the score matrix (contents are left for the caller to fill)
+     * @return Row-major storage: score of candidate c for row r is [r * candidates + c]
+     */
+    Score* prepare(size_t candidates, size_t rows = 1) {
+        candidates_ = candidates;
+        rows_ = rows;
+        scores_.resize(candidates * rows);
+        return scores_.data();
+    }
+
+    /**
+     * @brief Indices of the k best candidates of one row, best first
+     *
+     * The returned vector is reused by the next call.
+     */
+    const std::vector<uint32_t>& select(size_t k, size_t row = 0) {
+        order_.resize(candidates_);
+        std::iota(order_.begin(), order_.end(), 0u);
+        if (row >= rows_) {
+            order_.clear();
+            return order_;
+        }
+
+        const Score* s = scores_.data() + row * candidates_;
+        auto better = [s](uint32_t a, uint32_t b) {
+            return s[a] > s[b] || (s[a] == s[b] && a < b);
+        };
+
+        if (k < order_.size()) {
+            std::nth_element(order_.begin(), order_.begin() + k, order_.end(), better);
+            order_.resize(k);
+        }
+        std::sort(order_.begin(), order_.end(), better);
+        return order_;
+    }
+
+    size_t getCandidateCount() const { return candidates_; }
+    size_t getRowCount() const { return rows_; }
+
+private:
+    std::vector<Score> scores_;
+    std::vector<uint32_t> order_;
+    size_t candidates_;
+    size_t rows_;
+};
+
+} // namespace tribft
+
+#endif // TOPK_SELECTOR_H
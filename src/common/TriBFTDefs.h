@@ -5,8 +5,12 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <array>
+#include <bitset>
 #include <cmath>
+#include <algorithm>
 #include <omnetpp.h>
+#include "InteractionWeight.h"
 
 using namespace omnetpp;
 
@@ -17,10 +21,15 @@ namespace tribft {
 // ============================================================================
 
 using NodeID = std::string;
+using NodeIndex = uint32_t;         // Dense interned node ID (see NodeRegistry)
+using MessageID = uint64_t;         // Packed node/epoch/sequence ID (see IdGenerator)
 using ShardID = int;
 using BlockHeight = uint64_t;
 using ViewNumber = uint64_t;
 using ReputationScore = double;
+using VoterBitmap = std::bitset<256>;                // QC voters by consensus group slot (>= MAX_SHARD_SIZE)
+using AggregateSignature = std::array<uint8_t, 48>;  // Aggregated QC signature (BLS12-381 G1 size)
+using Hash256 = std::array<uint8_t, 32>;             // SHA-256 digest (see Sha256)
 
 // ============================================================================
 // ENUMS
@@ -33,7 +42,7 @@ enum class ConsensusPhase {
     COMMIT = 3
 };
 
-enum class ReputationEvent {
+enum class ReputationEvent : uint8_t {
     SUCCESSFUL_TX = 0,
     FAILED_TX = 1,
     SUCCESSFUL_VOTE = 2,
@@ -85,6 +94,52 @@ enum class ShardLevel {
 
 // Note: MessageType is defined in TriBFTMessage.msg and auto-generated
 
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+
+namespace Constants {
+    // Node Identity
+    constexpr NodeIndex INVALID_NODE_INDEX = static_cast<NodeIndex>(-1);
+    constexpr MessageID INVALID_MESSAGE_ID = 0;
+    
+    // Consensus Parameters
+    constexpr double QUORUM_RATIO = 2.0 / 3.0;  // > 2/3 for Byzantine Fault Tolerance
+    constexpr int MIN_QUORUM_SIZE = 2;           // Minimum quorum size
+    constexpr double CONSENSUS_TIMEOUT_SEC = 5.0; // Consensus timeout (seconds)
+    constexpr BlockHeight CHECKPOINT_INTERVAL = 16; // Heights between skip-list checkpoints (SkipChain)
+    constexpr int NO_GROUP_EPOCH = -1;           // No consensus group installed (QC has no voter slots)
+    
+    // Shard Parameters (optimized: smaller shard radius for better multi-hop efficiency)
+    constexpr double REGIONAL_SHARD_RADIUS = 3000.0;  // meters (3km radius, balance coverage and communication)
+    constexpr int MIN_SHARD_SIZE = 50;   // Minimum shard size (for smaller shards)
+    constexpr int MAX_SHARD_SIZE = 250;  // Maximum shard size (for smaller shards)
+    constexpr double SPLIT_THRESHOLD = 0.8;  // Split when > 80% full
+    constexpr double MERGE_THRESHOLD = 0.3;  // Merge when < 30% full
+    
+    // Reputation Parameters
+    constexpr double INITIAL_REPUTATION = 0.5;
+    constexpr double MIN_REPUTATION = 0.0;
+    constexpr double MAX_REPUTATION = 1.0;
+    constexpr double REPUTATION_DECAY_RATE = 0.01;
+    constexpr double REPUTATION_DECAY_INTERVAL_SEC = 5.0; // Decay tick period (applied lazily)
+    constexpr double REPUTATION_WEIGHT_LAMBDA = 0.1;     // lambda in w = exp(-lambda * N_local)
+    constexpr double TRUSTED_REPUTATION_THRESHOLD = 0.8; // R_final >= 0.8 is trusted level
+    constexpr double STANDARD_REPUTATION_THRESHOLD = 0.2; // 0.2 <= R_final < 0.8 is standard level
+    constexpr InteractionWeight DEFAULT_INTERACTION_WEIGHT(REPUTATION_WEIGHT_LAMBDA);  // Built at compile time
+    constexpr double REPUTATION_SUCCESS_REWARD = 0.05;
+    constexpr double REPUTATION_FAILURE_PENALTY = 0.1;
+    constexpr double REWARD_VALID_PROPOSAL = 0.03;
+    constexpr double PENALTY_INVALID_PROPOSAL = 0.08;
+    constexpr double REWARD_CORRECT_VOTE = 0.02;
+    constexpr double PENALTY_INCORRECT_VOTE = 0.05;
+    
+    // Network Parameters
+    constexpr int MAX_TRANSACTION_POOL_SIZE = 1000;
+    constexpr int DEFAULT_BATCH_SIZE = 100;
+    constexpr double DEFAULT_BLOCK_INTERVAL_SEC = 0.5;  // seconds
+}
+
 // ============================================================================
 // DATA STRUCTURES
 // ============================================================================
@@ -107,7 +162,7 @@ struct Transaction {
  * @brief Consensus Proposal
  */
 struct ConsensusProposal {
-    std::string proposalID;
+    MessageID proposalID;
     BlockHeight blockHeight;
     ViewNumber viewNumber;
     NodeID leaderID;
@@ -116,7 +171,7 @@ struct ConsensusProposal {
     std::vector<Transaction> transactions;
     std::string blockHash;
     
-    ConsensusProposal() : blockHeight(0), viewNumber(0), shardID(-1), proposalTime(0) {}
+    ConsensusProposal() : proposalID(Constants::INVALID_MESSAGE_ID), blockHeight(0), viewNumber(0), shardID(-1), proposalTime(0) {}
 };
 
 /**
@@ -125,36 +180,156 @@ struct ConsensusProposal {
  * Note: Renamed from VoteMessage to avoid conflict with generated message class
  */
 struct VoteInfo {
-    std::string proposalID;
+    MessageID proposalID;
     NodeID voterID;
     ConsensusPhase phase;
     bool approve;
     simtime_t voteTime;
     std::string signature;
     
-    VoteInfo() : phase(ConsensusPhase::IDLE), approve(false), voteTime(0) {}
+    VoteInfo() : proposalID(Constants::INVALID_MESSAGE_ID), phase(ConsensusPhase::IDLE), approve(false), voteTime(0) {}
 };
 
 /**
  * @brief Quorum Certificate
+ * 
+ * Constant size: voters are a bitmap over the consensus group's slot space
+ * and their signatures are folded into one aggregate (SignatureAggregator).
+ * Slot i is the i-th member of the group elected in epoch (primary nodes,
+ * then redundant nodes), so every node resolves the bitmap the same way;
+ * HotStuffEngine::getVoters() maps it back to node IDs.
  */
 struct QuorumCertificate {
-    std::string proposalID;
+    MessageID proposalID;
     ConsensusPhase phase;
     BlockHeight blockHeight;
     ViewNumber viewNumber;
-    std::vector<VoteInfo> votes;
+    VoterBitmap voters;
+    AggregateSignature signature;
     int totalVotes;
+    int epoch;               // Election the voter bitmap refers to (Constants::NO_GROUP_EPOCH: none)
     simtime_t timestamp;
     
-    QuorumCertificate() : phase(ConsensusPhase::IDLE), blockHeight(0), 
-                          viewNumber(0), totalVotes(0), timestamp(0) {}
+    QuorumCertificate() : proposalID(Constants::INVALID_MESSAGE_ID), phase(ConsensusPhase::IDLE),
+                          blockHeight(0), viewNumber(0), signature{}, totalVotes(0),
+                          epoch(Constants::NO_GROUP_EPOCH), timestamp(0) {}
     
     bool isValid(int quorumSize) const {
         return totalVotes >= quorumSize;
     }
 };
 
+/**
+ * @brief Bounded per-node event history (inline ring buffer)
+ * 
+ * Keeps the last CAPACITY events, oldest overwritten first. Each entry is
+ * 4 bytes: the event in the low byte and the time in TIME_QUANTUM steps
+ * in the upper 24 bits (saturating after ~19 days of simulated time).
+ * No heap memory; windowed counts scan newest-first and stop at the
+ * first entry older than the window.
+ */
+class EventHistory {
+public:
+    static constexpr size_t CAPACITY = 32;
+    static constexpr double TIME_QUANTUM = 0.1;  // seconds
+    
+    EventHistory() : entries_{}, head_(0), count_(0) {}
+    
+    /**
+     * @brief Append event (overwrites the oldest when full)
+     */
+    void push(ReputationEvent event, simtime_t time) {
+        entries_[head_] = (quantize(time) << 8) | static_cast<uint8_t>(event);
+        head_ = static_cast<uint8_t>((head_ + 1) % CAPACITY);
+        if (count_ < CAPACITY) {
+            ++count_;
+        }
+    }
+    
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    void clear() { head_ = 0; count_ = 0; }
+    
+    /**
+     * @brief Drop all but the newest n events
+     */
+    void keepLast(size_t n) {
+        if (n < count_) {
+            count_ = static_cast<uint8_t>(n);
+        }
+    }
+    
+    /**
+     * @brief Event / time by age order (0 = oldest retained)
+     */
+    ReputationEvent getEvent(size_t i) const { return static_cast<ReputationEvent>(at(i) & 0xFF); }
+    simtime_t getTime(size_t i) const { return (at(i) >> 8) * TIME_QUANTUM; }
+    
+    /**
+     * @brief Count events at or after since matching pred (resolution TIME_QUANTUM)
+     */
+    template <typename Pred>
+    size_t countSince(simtime_t since, Pred pred) const {
+        uint32_t from = quantize(since);
+        size_t n = 0;
+        for (size_t i = count_; i-- > 0;) {
+            uint32_t entry = at(i);
+            if ((entry >> 8) < from) {
+                break;
+            }
+            if (pred(static_cast<ReputationEvent>(entry & 0xFF))) {
+                ++n;
+            }
+        }
+        return n;
+    }
+    
+    size_t countSince(simtime_t since, ReputationEvent event) const {
+        return countSince(since, [event](ReputationEvent e) { return e == event; });
+    }
+    
+    size_t countFailuresSince(simtime_t since) const {
+        return countSince(since, isFailure);
+    }
+    
+    /**
+     * @brief Events that carry a penalty (see VRMManager::recordEvent)
+     */
+    static bool isFailure(ReputationEvent event) {
+        switch (event) {
+            case ReputationEvent::FAILED_TX:
+            case ReputationEvent::FAILED_VOTE:
+            case ReputationEvent::TIMEOUT:
+            case ReputationEvent::MALICIOUS_BEHAVIOR:
+            case ReputationEvent::PROPOSE_INVALID_BLOCK:
+            case ReputationEvent::VOTE_INCORRECTLY:
+            case ReputationEvent::FAILED_CONSENSUS:
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+private:
+    static constexpr uint32_t MAX_QUANTUM = (1u << 24) - 1;
+    
+    static uint32_t quantize(simtime_t time) {
+        double steps = SIMTIME_DBL(time) / TIME_QUANTUM;
+        if (steps <= 0.0) {
+            return 0;
+        }
+        return steps >= MAX_QUANTUM ? MAX_QUANTUM : static_cast<uint32_t>(steps);
+    }
+    
+    uint32_t at(size_t i) const {
+        return entries_[(head_ + CAPACITY - count_ + i) % CAPACITY];
+    }
+    
+    std::array<uint32_t, CAPACITY> entries_;
+    uint8_t head_;
+    uint8_t count_;
+};
+
 /**
  * @brief Reputation Record
  */
@@ -165,6 +340,7 @@ struct ReputationRecord {
     ReputationScore globalReputation;   // R_global: Cross-domain long-term reputation
     ReputationScore localPerformance;   // R_local: Local instant performance score
     int localInteractionCount;          // N_local: Local interaction count
+    ReputationScore finalReputation;    // R_final, cached (see refreshFinalReputation)
     
     // Legacy field (backward compatible)
     ReputationScore score;  // Final reputation (dynamically calculated)
@@ -177,31 +353,36 @@ struct ReputationRecord {
     int correctVotes;
     int totalVotes;
     simtime_t lastUpdate;
-    std::vector<ReputationEvent> recentEvents;
+    EventHistory recentEvents;          // Last EventHistory::CAPACITY events
     
     ReputationRecord() : globalReputation(0.5), localPerformance(0.5), 
-                        localInteractionCount(0), score(0.5),
+                        localInteractionCount(0), finalReputation(0.5), score(0.5),
                         successfulTx(0), failedTx(0),
                         validProposals(0), totalProposals(0),
                         correctVotes(0), totalVotes(0), lastUpdate(0) {}
     
     explicit ReputationRecord(const NodeID& id) : nodeID(id), 
                                                    globalReputation(0.5), localPerformance(0.5),
-                                                   localInteractionCount(0), score(0.5),
+                                                   localInteractionCount(0), finalReputation(0.5), score(0.5),
                                                    successfulTx(0), failedTx(0),
                                                    validProposals(0), totalProposals(0),
                                                    correctVotes(0), totalVotes(0), lastUpdate(0) {}
     
     /**
-     * @brief Calculate final reputation (dynamic weighting)
+     * @brief Final reputation (dynamic weighting), cached
      * R_final = w * R_global + (1-w) * R_local
      * where w = exp(-lambda * N_local)
      */
     double getFinalReputation() const {
-        // lambda = 0.1 (decay coefficient from paper)
-        const double LAMBDA = 0.1;
-        double w = std::exp(-LAMBDA * localInteractionCount);
-        return w * globalReputation + (1.0 - w) * localPerformance;
+        return finalReputation;
+    }
+    
+    /**
+     * @brief Recompute cached R_final; call after changing any dual-model field
+     */
+    void refreshFinalReputation(const InteractionWeight& weight = Constants::DEFAULT_INTERACTION_WEIGHT) {
+        double w = weight(localInteractionCount);
+        finalReputation = w * globalReputation + (1.0 - w) * localPerformance;
     }
     
     /**
@@ -209,7 +390,7 @@ struct ReputationRecord {
      * Paper: R_final >= 0.8 is trusted level
      */
     bool isReliable() const {
-        return getFinalReputation() >= 0.8;  // Trusted level threshold
+        return getFinalReputation() >= Constants::TRUSTED_REPUTATION_THRESHOLD;
     }
     
     /**
@@ -218,7 +399,7 @@ struct ReputationRecord {
      */
     bool isStandard() const {
         double r = getFinalReputation();
-        return r >= 0.2 && r < 0.8;
+        return r >= Constants::STANDARD_REPUTATION_THRESHOLD && r < Constants::TRUSTED_REPUTATION_THRESHOLD;
     }
     
     /**
@@ -227,7 +408,7 @@ struct ReputationRecord {
      */
     bool isCandidate() const {
         double r = getFinalReputation();
-        return r > 0.0 && r < 0.2;
+        return r > 0.0 && r < Constants::STANDARD_REPUTATION_THRESHOLD;
     }
 };
 
@@ -247,6 +428,30 @@ struct Block {
     Block() : height(0), shardID(-1), timestamp(0) {}
 };
 
+/**
+ * @brief What a catch-up range request asks for (see RangeSync)
+ */
+enum class SyncRangeKind : uint8_t {
+    HEADERS = 0,
+    BLOCKS = 1,
+    CHECKPOINTS = 2            // first = trusted checkpoint, first + count = target
+};
+
+/**
+ * @brief Catch-up range request as sent on the wire (see ConsensusCodec)
+ */
+struct SyncRequest {
+    MessageID requestID;
+    ShardID shardID;           // Chain asked for (the requester's shard)
+    SyncRangeKind kind;
+    BlockHeight first;
+    uint32_t count;
+    NodeIndex peer;            // Node asked to serve the range
+    
+    SyncRequest() : requestID(Constants::INVALID_MESSAGE_ID), shardID(-1), kind(SyncRangeKind::HEADERS),
+                    first(0), count(0), peer(Constants::INVALID_NODE_INDEX) {}
+};
+
 /**
  * @brief Geographic Coordinate
  */
@@ -272,7 +477,7 @@ struct ShardInfo {
     ShardLevel level;
     GeoCoord centerPoint;
     double radius;
-    std::set<NodeID> members;
+    std::vector<NodeIndex> members;     // Interned member IDs (NodeRegistry), sorted
     NodeID leader;
     simtime_t creationTime;
     simtime_t lastUpdate;
@@ -290,6 +495,27 @@ struct ShardInfo {
     size_t getMemberCount() const {
         return members.size();
     }
+    
+    bool hasMember(NodeIndex nodeIndex) const {
+        return std::binary_search(members.begin(), members.end(), nodeIndex);
+    }
+    
+    /**
+     * @brief Insert keeping members sorted (no-op if already a member)
+     */
+    void addMember(NodeIndex nodeIndex) {
+        auto it = std::lower_bound(members.begin(), members.end(), nodeIndex);
+        if (it == members.end() || *it != nodeIndex) {
+            members.insert(it, nodeIndex);
+        }
+    }
+    
+    void removeMember(NodeIndex nodeIndex) {
+        auto it = std::lower_bound(members.begin(), members.end(), nodeIndex);
+        if (it != members.end() && *it == nodeIndex) {
+            members.erase(it);
+        }
+    }
 };
 
 /**
@@ -326,41 +552,6 @@ struct ShardMetrics {
                      splitCount(0), mergeCount(0), loadBalance(0.0) {}
 };
 
-// ============================================================================
-// CONSTANTS
-// ============================================================================
-
-namespace Constants {
-    // Consensus Parameters
-    constexpr double QUORUM_RATIO = 2.0 / 3.0;  // > 2/3 for Byzantine Fault Tolerance
-    constexpr int MIN_QUORUM_SIZE = 2;           // Minimum quorum size
-    constexpr double CONSENSUS_TIMEOUT_SEC = 5.0; // Consensus timeout (seconds)
-    
-    // Shard Parameters (optimized: smaller shard radius for better multi-hop efficiency)
-    constexpr double REGIONAL_SHARD_RADIUS = 3000.0;  // meters (3km radius, balance coverage and communication)
-    constexpr int MIN_SHARD_SIZE = 50;   // Minimum shard size (for smaller shards)
-    constexpr int MAX_SHARD_SIZE = 250;  // Maximum shard size (for smaller shards)
-    constexpr double SPLIT_THRESHOLD = 0.8;  // Split when > 80% full
-    constexpr double MERGE_THRESHOLD = 0.3;  // Merge when < 30% full
-    
-    // Reputation Parameters
-    constexpr double INITIAL_REPUTATION = 0.5;
-    constexpr double MIN_REPUTATION = 0.0;
-    constexpr double MAX_REPUTATION = 1.0;
-    constexpr double REPUTATION_DECAY_RATE = 0.01;
-    constexpr double REPUTATION_SUCCESS_REWARD = 0.05;
-    constexpr double REPUTATION_FAILURE_PENALTY = 0.1;
-    constexpr double REWARD_VALID_PROPOSAL = 0.03;
-    constexpr double PENALTY_INVALID_PROPOSAL = 0.08;
-    constexpr double REWARD_CORRECT_VOTE = 0.02;
-    constexpr double PENALTY_INCORRECT_VOTE = 0.05;
-    
-    // Network Parameters
-    constexpr int MAX_TRANSACTION_POOL_SIZE = 1000;
-    constexpr int DEFAULT_BATCH_SIZE = 100;
-    constexpr double DEFAULT_BLOCK_INTERVAL_SEC = 0.5;  // seconds
-}
-
 } // namespace tribft
 
 #endif // TRIBFT_DEFS_H
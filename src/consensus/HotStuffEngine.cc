@@ -1,15 +1,21 @@
 #include "HotStuffEngine.h"
+#include "../common/NodeRegistry.h"
+#include "../blockchain/BlockLog.h"
 #include <sstream>
-#include <iomanip>
+#include <algorithm>
 
 namespace tribft {
 
 HotStuffEngine::HotStuffEngine()
-    : shardSize_(0)
+    : proposalIDs_(std::make_shared<IdGenerator>())
+    , shardSize_(0)
     , currentPhase_(ConsensusPhase::IDLE)
     , currentView_(0)
     , currentHeight_(0)
     , hasActiveProposal_(false)
+    , aggregator_(std::make_shared<SimulatedBLSAggregator>())
+    , committedWindow_(16)
+    , pipelineDepth_(1)
     , consensusStartTime_(0)
 {
 }
@@ -17,6 +23,7 @@ HotStuffEngine::HotStuffEngine()
 void HotStuffEngine::initialize(const NodeID& nodeID, ShardID shardID) {
     nodeID_ = nodeID;
     shardID_ = shardID;
+    proposalIDs_ = std::make_shared<IdGenerator>(NodeRegistry::getGlobalInstance().intern(nodeID_));
     currentPhase_ = ConsensusPhase::IDLE;
     currentView_ = 0;
     currentHeight_ = 0;
@@ -30,6 +37,93 @@ void HotStuffEngine::setShardSize(int size) {
     log("Shard size set to " + std::to_string(size));
 }
 
+void HotStuffEngine::switchShard(ShardID shardID) {
+    if (shardID == shardID_) {
+        return;
+    }
+    
+    log("Switching from shard " + std::to_string(shardID_) + " to " + std::to_string(shardID));
+    
+    resetConsensusState();
+    shardID_ = shardID;
+    
+    // Chain position belongs to the old shard; the new shard's next proposal resyncs it
+    currentView_ = 0;
+    currentHeight_ = 0;
+    previousBlockHash_.clear();
+    highestQC_ = QuorumCertificate();
+    
+    // Groups are elected per shard; the owner installs the new shard's group
+    voterGroup_ = VoterGroup();
+    previousVoterGroup_ = VoterGroup();
+}
+
+void HotStuffEngine::setPipelineDepth(int depth) {
+    if (isInProgress()) {
+        log("Cannot change pipeline depth while consensus is in progress");
+        return;
+    }
+    // The three-chain commit rule needs h, h+1 and h+2 certified together,
+    // so a chained pipeline shallower than three heights would never commit
+    if (depth == 2) {
+        log("Chained pipeline depth 2 cannot satisfy the three-chain commit rule, using 3");
+        depth = 3;
+    }
+    pipelineDepth_ = std::max(1, depth);
+    log(std::string(isChained() ? "Chained" : "Classic") + " HotStuff, pipeline depth " + 
+        std::to_string(pipelineDepth_));
+}
+
+void HotStuffEngine::setConsensusGroup(const ConsensusGroup& group) {
+    if (group.primaryNodes.empty() && group.redundantNodes.empty()) {
+        log("Empty consensus group for epoch " + std::to_string(group.epoch) +
+            ", keeping the current voter slots");
+        return;
+    }
+    
+    if (group.epoch != voterGroup_.epoch) {
+        previousVoterGroup_ = std::move(voterGroup_);
+    }
+    voterGroup_ = VoterGroup();
+    voterGroup_.epoch = group.epoch;
+    
+    const size_t maxSlots = VoterBitmap().size();
+    for (const auto* nodes : {&group.primaryNodes, &group.redundantNodes}) {
+        for (const NodeID& member : *nodes) {
+            if (voterGroup_.members.size() >= maxSlots) {
+                log("Consensus group exceeds " + std::to_string(maxSlots) + " QC voter slots, ignoring " + member);
+                continue;
+            }
+            if (voterGroup_.slots.emplace(member, static_cast<int>(voterGroup_.members.size())).second) {
+                voterGroup_.members.push_back(member);
+            }
+        }
+    }
+    
+    log("Consensus group for epoch " + std::to_string(group.epoch) + ": " +
+        std::to_string(voterGroup_.members.size()) + " voter slots");
+}
+
+void HotStuffEngine::setCommittedBlockLog(const std::string& logPrefix, size_t window) {
+    blockLogPrefix_ = logPrefix;
+    committedWindow_ = std::max<size_t>(1, window);
+    if (committedBlocks_.size() > committedWindow_) {
+        committedBlocks_.pop_front(committedBlocks_.size() - committedWindow_);
+    }
+}
+
+void HotStuffEngine::setSignatureAggregator(std::shared_ptr<SignatureAggregator> aggregator) {
+    if (aggregator) {
+        aggregator_ = aggregator;
+    }
+}
+
+void HotStuffEngine::setProposalIdGenerator(std::shared_ptr<IdGenerator> generator) {
+    if (generator) {
+        proposalIDs_ = generator;
+    }
+}
+
 void HotStuffEngine::setProposalCallback(ProposalCallback callback) {
     proposalCallback_ = callback;
 }
@@ -50,6 +144,10 @@ void HotStuffEngine::setPhaseAdvanceCallback(PhaseAdvanceCallback callback) {
     phaseAdvanceCallback_ = callback;
 }
 
+void HotStuffEngine::setLatencyCallback(LatencyCallback callback) {
+    latencyCallback_ = callback;
+}
+
 // ============================================================================
 // LEADER INTERFACE
 // ============================================================================
@@ -68,23 +166,37 @@ bool HotStuffEngine::proposeBlock(const std::vector<Transaction>& transactions)
     // Create proposal
     ConsensusProposal proposal;
     proposal.proposalID = generateProposalID();
-    proposal.blockHeight = currentHeight_ + 1;
+    proposal.blockHeight = getNextHeight();
     proposal.viewNumber = currentView_;
     proposal.leaderID = nodeID_;
     proposal.shardID = shardID_;
     proposal.proposalTime = simTime();
     proposal.transactions = transactions;
     
-    // Calculate block hash
+    // Calculate block hash (chained mode extends the newest in-flight block)
+    const std::string& parentHash = (isChained() && !pipeline_.empty()) 
+        ? pipeline_.rbegin()->second.proposal.blockHash : previousBlockHash_;
     std::stringstream ss;
-    ss << proposal.blockHeight << "_" << previousBlockHash_ << "_" << proposal.proposalTime;
+    ss << proposal.blockHeight << "_" << parentHash << "_" << proposal.proposalTime;
     proposal.blockHash = ss.str();
     
-    // Set as current proposal
-    currentProposal_ = proposal;
-    hasActiveProposal_ = true;
-    currentPhase_ = ConsensusPhase::PREPARE;
-    consensusStartTime_ = simTime();
+    pruneVotes();
+    votes_.emplace(proposal.proposalID, VoteAccumulator(proposal.blockHeight, voterGroup_.epoch));
+    
+    if (isChained()) {
+        InFlightBlock& entry = pipeline_[proposal.blockHeight];
+        entry.proposal = proposal;
+        entry.phase = ConsensusPhase::PREPARE;
+        entry.startTime = simTime();
+        pipelineIndex_[proposal.proposalID] = proposal.blockHeight;
+        currentPhase_ = ConsensusPhase::PREPARE;
+    } else {
+        // Set as current proposal
+        currentProposal_ = proposal;
+        hasActiveProposal_ = true;
+        currentPhase_ = ConsensusPhase::PREPARE;
+        consensusStartTime_ = simTime();
+    }
     
     metrics_.totalProposals++;
     
@@ -103,6 +215,9 @@ bool HotStuffEngine::proposeBlock(const std::vector<Transaction>& transactions)
 }
 
 bool HotStuffEngine::canPropose() const {
+    if (isChained()) {
+        return pipeline_.size() < static_cast<size_t>(pipelineDepth_);
+    }
     return currentPhase_ == ConsensusPhase::IDLE && !hasActiveProposal_;
 }
 
@@ -111,7 +226,7 @@ bool HotStuffEngine::canPropose() const {
 // ============================================================================
 
 void HotStuffEngine::handleProposal(const ConsensusProposal& proposal) {
-    std::cout << "  [ENGINE] " << nodeID_ << " validating proposal " << proposal.proposalID << std::endl;
+    std::cout << "  [ENGINE] " << nodeID_ << " validating proposal " << IdGenerator::toString(proposal.proposalID) << std::endl;
     std::cout << "    My shard: " << shardID_ << ", Proposal shard: " << proposal.shardID << std::endl;
     std::cout << "    My height: " << currentHeight_ << ", Proposal height: " << proposal.blockHeight << std::endl;
     
@@ -124,6 +239,22 @@ void HotStuffEngine::handleProposal(const ConsensusProposal& proposal) {
     
     std::cout << "  [ENGINE] Validation SUCCESS!" << std::endl;
     
+    pruneVotes();
+    votes_.emplace(proposal.proposalID, VoteAccumulator(proposal.blockHeight, voterGroup_.epoch));
+    
+    if (isChained()) {
+        InFlightBlock& entry = pipeline_[proposal.blockHeight];
+        entry.proposal = proposal;
+        entry.phase = ConsensusPhase::PREPARE;
+        entry.startTime = simTime();
+        pipelineIndex_[proposal.proposalID] = proposal.blockHeight;
+        currentPhase_ = ConsensusPhase::PREPARE;
+        
+        // Generic vote: certifies this height and, transitively, its ancestors
+        sendVote(proposal, ConsensusPhase::PREPARE, true);
+        return;
+    }
+    
     // Accept proposal
     currentProposal_ = proposal;
     hasActiveProposal_ = true;
@@ -135,15 +266,26 @@ void HotStuffEngine::handleProposal(const ConsensusProposal& proposal) {
 }
 
 void HotStuffEngine::handleVote(const VoteInfo& vote) {
+    if (isChained()) {
+        handleChainedVote(vote);
+        return;
+    }
+    
     if (!hasActiveProposal_ || vote.proposalID != currentProposal_.proposalID) {
         log("Vote for unknown proposal ignored");
         return;
     }
     
-    // Store vote
-    voteStore_[vote.proposalID][vote.phase].push_back(vote);
+    // Store vote (a voter counts once per phase)
+    VoteAccumulator::AddResult result = recordVote(vote);
+    if (result != VoteAccumulator::AddResult::ADDED) {
+        log(std::string(result == VoteAccumulator::AddResult::DUPLICATE ? "Duplicate" : "Invalid") + 
+            " vote from " + vote.voterID + " ignored");
+        return;
+    }
     
-    int voteCount = voteStore_[vote.proposalID][vote.phase].size();
+    const VoteAccumulator& accumulator = votes_.at(vote.proposalID);
+    int voteCount = accumulator.getApprovals(vote.phase) + accumulator.getRejections(vote.phase);
     std::cout << "  [ENGINE-VOTE] " << nodeID_ << " got vote from " << vote.voterID 
               << " phase=" << static_cast<int>(vote.phase)
               << " current_phase=" << static_cast<int>(currentPhase_)
@@ -189,6 +331,13 @@ void HotStuffEngine::handleVote(const VoteInfo& vote) {
 }
 
 void HotStuffEngine::handleTimeout() {
+    if (isChained() && !pipeline_.empty()) {
+        log("Consensus timeout - dropping " + std::to_string(pipeline_.size()) + " uncommitted heights");
+        metrics_.failedConsensus += static_cast<int>(pipeline_.size());
+        resetConsensusState();
+        return;
+    }
+    
     if (hasActiveProposal_) {
         log("Consensus timeout - resetting state");
         metrics_.failedConsensus++;
@@ -201,20 +350,58 @@ void HotStuffEngine::handleTimeout() {
 // ============================================================================
 
 const ConsensusProposal* HotStuffEngine::getCurrentProposal() const {
+    if (isChained()) {
+        return pipeline_.empty() ? nullptr : &pipeline_.rbegin()->second.proposal;
+    }
     if (hasActiveProposal_) {
         return &currentProposal_;
     }
     return nullptr;
 }
 
+BlockRef HotStuffEngine::getCommittedBlock(BlockHeight height) const {
+    // Window is in commit order; height jumps (syncToHeight) may leave gaps
+    for (size_t i = committedBlocks_.size(); i-- > 0;) {
+        if (committedBlocks_[i].body->height == height) {
+            return committedBlocks_[i].body;
+        }
+    }
+    
+    BlockLog* blockLog = BlockLog::getShardLog(blockLogPrefix_, shardID_);
+    Block block;
+    if (!blockLog || !blockLog->read(height, block)) {
+        return nullptr;
+    }
+    block.qc = QuorumCertificate();
+    return BlockStore::getGlobalInstance().intern(std::move(block));
+}
+
 const QuorumCertificate* HotStuffEngine::getHighestQC() const {
-    if (!highestQC_.proposalID.empty()) {
+    if (highestQC_.proposalID != Constants::INVALID_MESSAGE_ID) {
         return &highestQC_;
     }
     return nullptr;
 }
 
+std::vector<NodeID> HotStuffEngine::getVoters(const QuorumCertificate& qc) const {
+    std::vector<NodeID> voters;
+    const VoterGroup* group = findVoterGroup(qc.epoch);
+    if (!group) {
+        return voters;
+    }
+    voters.reserve(qc.voters.count());
+    for (size_t slot = 0; slot < group->members.size(); ++slot) {
+        if (qc.voters.test(slot)) {
+            voters.push_back(group->members[slot]);
+        }
+    }
+    return voters;
+}
+
 bool HotStuffEngine::isInProgress() const {
+    if (isChained()) {
+        return !pipeline_.empty();
+    }
     return hasActiveProposal_ && currentPhase_ != ConsensusPhase::IDLE;
 }
 
@@ -224,17 +411,18 @@ bool HotStuffEngine::isInProgress() const {
 
 bool HotStuffEngine::validateProposal(const ConsensusProposal& proposal) {
     // Basic validation
-    if (proposal.proposalID.empty() || proposal.blockHash.empty()) {
+    if (proposal.proposalID == Constants::INVALID_MESSAGE_ID || proposal.blockHash.empty()) {
         log("Invalid proposal: empty ID or hash");
         return false;
     }
     
     // Check height
-    if (proposal.blockHeight != currentHeight_ + 1) {
+    BlockHeight expectedHeight = getNextHeight();
+    if (proposal.blockHeight != expectedHeight) {
         std::cout << "[HEIGHT-MISMATCH] " << nodeID_ << " currentHeight=" << currentHeight_ 
-                  << " expected=" << (currentHeight_ + 1) 
+                  << " expected=" << expectedHeight 
                   << " proposal=" << proposal.blockHeight << std::endl;
-        log("Invalid height: expected " + std::to_string(currentHeight_ + 1) + 
+        log("Invalid height: expected " + std::to_string(expectedHeight) + 
             ", got " + std::to_string(proposal.blockHeight));
         return false;
     }
@@ -274,7 +462,7 @@ void HotStuffEngine::sendVote(const ConsensusProposal& proposal, ConsensusPhase
     vote.phase = phase;
     vote.approve = approve;
     vote.voteTime = simTime();
-    vote.signature = nodeID_ + "_" + proposal.proposalID;  // Simplified signature
+    vote.signature = nodeID_ + "_" + std::to_string(proposal.proposalID);  // Simplified signature
     
     // No longer add directly to voteStore_, handle uniformly via handleVote
     // This ensures vote counting consistency
@@ -285,16 +473,25 @@ void HotStuffEngine::sendVote(const ConsensusProposal& proposal, ConsensusPhase
     }
 }
 
-bool HotStuffEngine::hasQuorum(const std::string& proposalID, ConsensusPhase phase) {
-    // TODO: Core implementation hidden - will be released after project completion
-    return false;
+bool HotStuffEngine::hasQuorum(MessageID proposalID, ConsensusPhase phase) {
+    auto it = votes_.find(proposalID);
+    return it != votes_.end() && it->second.hasQuorum(phase, getQuorumSize());
 }
 
 void HotStuffEngine::advancePhase() {
     // TODO: Core implementation hidden - will be released after project completion
 }
 
-void HotStuffEngine::handlePhaseAdvance(const std::string& proposalID, ConsensusPhase toPhase) {
+void HotStuffEngine::handlePhaseAdvance(MessageID proposalID, ConsensusPhase toPhase) {
+    // Chained mode: the leader announces a certified height, no extra vote round
+    if (isChained()) {
+        InFlightBlock* entry = findInFlight(proposalID);
+        if (entry && toPhase == ConsensusPhase::PRE_COMMIT && entry->phase == ConsensusPhase::PREPARE) {
+            certifyHeight(*entry);
+        }
+        return;
+    }
+    
     // Verify this is for our current proposal
     if (proposalID != currentProposal_.proposalID) {
         std::cout << "  [PHASE-ADVANCE] Ignoring advance for different proposal" << std::endl;
@@ -336,11 +533,8 @@ void HotStuffEngine::commitBlock() {
     // TODO: Core implementation hidden - will be released after project completion
 }
 
-std::string HotStuffEngine::generateProposalID() {
-    std::stringstream ss;
-    ss << nodeID_ << "_" << currentView_ << "_" << (currentHeight_ + 1) << "_" 
-       << std::setprecision(6) << simTime();
-    return ss.str();
+MessageID HotStuffEngine::generateProposalID() {
+    return proposalIDs_->next();
 }
 
 int HotStuffEngine::getQuorumSize() const {
@@ -350,41 +544,102 @@ int HotStuffEngine::getQuorumSize() const {
     return 2;
 }
 
-QuorumCertificate HotStuffEngine::createQC(const std::string& proposalID, ConsensusPhase phase) {
+QuorumCertificate HotStuffEngine::createQC(MessageID proposalID, ConsensusPhase phase) {
     QuorumCertificate qc;
     qc.proposalID = proposalID;
     qc.phase = phase;
     qc.blockHeight = currentProposal_.blockHeight;
     qc.viewNumber = currentView_;
+    qc.timestamp = simTime();
     
-    auto propIt = voteStore_.find(proposalID);
-    if (propIt != voteStore_.end()) {
-        auto phaseIt = propIt->second.find(phase);
-        if (phaseIt != propIt->second.end()) {
-            qc.votes = phaseIt->second;
-        }
+    auto it = votes_.find(proposalID);
+    if (it != votes_.end()) {
+        it->second.fillQC(phase, qc);
     }
     
     return qc;
 }
 
+VoteAccumulator::AddResult HotStuffEngine::recordVote(const VoteInfo& vote) {
+    auto it = votes_.find(vote.proposalID);
+    if (it == votes_.end()) {
+        return VoteAccumulator::AddResult::INVALID;
+    }
+    
+    // Slots are fixed when the proposal opens, so a re-election mid-round
+    // cannot mix two groups in one bitmap
+    int slot = getVoterSlot(vote.voterID, it->second.getEpoch());
+    if (slot < 0 && it->second.getEpoch() == Constants::NO_GROUP_EPOCH) {
+        log("No consensus group installed when the proposal opened, vote from " + vote.voterID + " not counted");
+        return VoteAccumulator::AddResult::INVALID;
+    }
+    if (slot < 0) {
+        log(vote.voterID + " has no voter slot in the epoch " + std::to_string(it->second.getEpoch()) +
+            " consensus group");
+        return VoteAccumulator::AddResult::INVALID;
+    }
+    return it->second.add(vote.phase, slot, vote.approve, vote.signature, *aggregator_);
+}
+
+void HotStuffEngine::pruneVotes() {
+    for (auto it = votes_.begin(); it != votes_.end(); ) {
+        if (it->second.getHeight() <= currentHeight_) {
+            it = votes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int HotStuffEngine::getVoterSlot(const NodeID& voterID, int epoch) const {
+    // No group installed (NO_GROUP_EPOCH): the empty default group gives no slot
+    const VoterGroup* group = findVoterGroup(epoch);
+    if (!group) {
+        return -1;
+    }
+    auto it = group->slots.find(voterID);
+    return it != group->slots.end() ? it->second : -1;
+}
+
+const HotStuffEngine::VoterGroup* HotStuffEngine::findVoterGroup(int epoch) const {
+    if (voterGroup_.epoch == epoch) {
+        return &voterGroup_;
+    }
+    if (previousVoterGroup_.epoch == epoch) {
+        return &previousVoterGroup_;
+    }
+    return nullptr;
+}
+
 void HotStuffEngine::resetConsensusState() {
     currentPhase_ = ConsensusPhase::IDLE;
     hasActiveProposal_ = false;
-    voteStore_.clear();
+    votes_.clear();
     phaseQCs_.clear();
+    pipeline_.clear();
+    pipelineIndex_.clear();
+}
+
+BlockHeight HotStuffEngine::getNextHeight() const {
+    if (isChained() && !pipeline_.empty()) {
+        return pipeline_.rbegin()->first + 1;
+    }
+    return currentHeight_ + 1;
 }
 
-void HotStuffEngine::syncToHeight(BlockHeight newHeight) {
+void HotStuffEngine::syncToHeight(BlockHeight newHeight, const std::string& tipHash) {
     if (newHeight > currentHeight_) {
         std::cout << "[SYNC-ENGINE] " << nodeID_ << " updating height from " 
-                  << currentHeight_ << " to " << newHeight << std::endl;
+                  << currentHeight_ << " to " << newHeight
+                  << (tipHash.empty() ? " (unverified)" : " (verified headers)") << std::endl;
         currentHeight_ = newHeight;
-        // In production system, this should:
-        // 1. Request and verify missing blocks
-        // 2. Apply state transitions
-        // 3. Update Merkle tree
-        // Simplified: directly update height
+        // Next proposal links to the fetched tip
+        if (!tipHash.empty()) {
+            previousBlockHash_ = tipHash;
+        }
+        pruneVotes();
+        // Missing headers/blocks are fetched and verified by the caller (RangeSync);
+        // there is no state machine to replay transactions into
     }
 }
 
@@ -394,5 +649,177 @@ void HotStuffEngine::log(const std::string& message) {
     }
 }
 
+// ============================================================================
+// CHAINED MODE
+// ============================================================================
+
+HotStuffEngine::InFlightBlock* HotStuffEngine::findInFlight(MessageID proposalID) {
+    auto idxIt = pipelineIndex_.find(proposalID);
+    if (idxIt == pipelineIndex_.end()) {
+        return nullptr;
+    }
+    auto it = pipeline_.find(idxIt->second);
+    return it != pipeline_.end() ? &it->second : nullptr;
+}
+
+void HotStuffEngine::handleChainedVote(const VoteInfo& vote) {
+    InFlightBlock* entry = findInFlight(vote.proposalID);
+    if (!entry) {
+        log("Vote for unknown proposal ignored");
+        return;
+    }
+    
+    VoteAccumulator::AddResult result = recordVote(vote);
+    if (result != VoteAccumulator::AddResult::ADDED) {
+        log(std::string(result == VoteAccumulator::AddResult::DUPLICATE ? "Duplicate" : "Invalid") + 
+            " vote from " + vote.voterID + " ignored");
+        return;
+    }
+    
+    log("Received vote from " + vote.voterID + " for height " + 
+        std::to_string(entry->proposal.blockHeight) +
+        " (" + (vote.approve ? "approve" : "reject") + ")");
+    
+    // Only generic (PREPARE) votes exist in chained mode
+    if (vote.phase != ConsensusPhase::PREPARE || entry->phase != ConsensusPhase::PREPARE) {
+        return;
+    }
+    
+    if (!hasQuorum(vote.proposalID, ConsensusPhase::PREPARE)) {
+        return;
+    }
+    
+    entry->qc.proposalID = entry->proposal.proposalID;
+    entry->qc.phase = ConsensusPhase::PREPARE;
+    entry->qc.blockHeight = entry->proposal.blockHeight;
+    entry->qc.viewNumber = entry->proposal.viewNumber;
+    entry->qc.timestamp = simTime();
+    votes_.at(vote.proposalID).fillQC(ConsensusPhase::PREPARE, entry->qc);
+    highestQC_ = entry->qc;
+    
+    log("Quorum reached for height " + std::to_string(entry->proposal.blockHeight));
+    
+    // Certify first: committing may erase the entry, and the callback can
+    // re-enter the engine, so neither may touch it afterwards
+    MessageID proposalID = entry->proposal.proposalID;
+    certifyHeight(*entry);
+    
+    // Tell followers (their copy of the chain advances the same way)
+    if (phaseAdvanceCallback_) {
+        phaseAdvanceCallback_(proposalID, ConsensusPhase::PREPARE, ConsensusPhase::PRE_COMMIT);
+    }
+}
+
+void HotStuffEngine::certifyHeight(InFlightBlock& entry) {
+    BlockHeight height = entry.proposal.blockHeight;
+    entry.phase = ConsensusPhase::PRE_COMMIT;
+    
+    // Two-chain: parent is now locked (QCs may also arrive child-first)
+    auto parentIt = pipeline_.find(height - 1);
+    if (parentIt != pipeline_.end() && parentIt->second.phase == ConsensusPhase::PRE_COMMIT) {
+        parentIt->second.phase = ConsensusPhase::COMMIT;
+    }
+    auto childIt = pipeline_.find(height + 1);
+    if (childIt != pipeline_.end() && childIt->second.phase != ConsensusPhase::PREPARE) {
+        entry.phase = ConsensusPhase::COMMIT;
+    }
+    
+    commitChain();
+}
+
+void HotStuffEngine::commitChain() {
+    // Three-chain: h commits once h, h+1 and h+2 are all certified
+    while (!pipeline_.empty()) {
+        auto it = pipeline_.begin();
+        auto child = std::next(it);
+        if (child == pipeline_.end()) {
+            break;
+        }
+        auto grandchild = std::next(child);
+        if (grandchild == pipeline_.end()) {
+            break;
+        }
+        
+        bool consecutive = child->first == it->first + 1 && grandchild->first == it->first + 2;
+        if (!consecutive || it->second.phase != ConsensusPhase::COMMIT ||
+            child->second.phase == ConsensusPhase::PREPARE ||
+            grandchild->second.phase == ConsensusPhase::PREPARE) {
+            break;
+        }
+        
+        commitInFlight(it->second);
+        pipelineIndex_.erase(it->second.proposal.proposalID);
+        pipeline_.erase(it);
+    }
+    
+    currentPhase_ = pipeline_.empty() ? ConsensusPhase::IDLE : ConsensusPhase::PREPARE;
+}
+
+void HotStuffEngine::commitInFlight(InFlightBlock& entry) {
+    ConsensusProposal& proposal = entry.proposal;
+    
+    // The entry is dropped after the commit, so its transactions move into the block
+    Block block;
+    block.height = proposal.blockHeight;
+    block.blockHash = proposal.blockHash;
+    block.previousHash = previousBlockHash_;
+    block.shardID = proposal.shardID;
+    block.transactions = std::move(proposal.transactions);
+    block.qc = entry.qc;
+    block.timestamp = proposal.proposalTime;   // Same on every member (commit time is per node)
+    block.proposer = proposal.leaderID;
+    
+    currentHeight_ = block.height;
+    previousBlockHash_ = block.blockHash;
+    votes_.erase(proposal.proposalID);
+    
+    // Per-height latency (proposal to commit)
+    simtime_t latency = simTime() - entry.startTime;
+    double latencySec = latency.dbl();
+    metrics_.successfulCommits++;
+    metrics_.totalTransactions += static_cast<int>(block.transactions.size());
+    metrics_.totalLatency += latencySec;
+    metrics_.avgLatency = metrics_.totalLatency / metrics_.successfulCommits;
+    metrics_.minLatency = std::min(metrics_.minLatency, latencySec);
+    metrics_.maxLatency = std::max(metrics_.maxLatency, latencySec);
+    
+    const CommittedBlock& committed = storeCommittedBlock(std::move(block));
+    
+    log("Committed block " + std::to_string(committed.body->height) + " (chained, latency " + 
+        std::to_string(latencySec) + "s)");
+    
+    if (latencyCallback_) {
+        latencyCallback_(committed.body->height, latency);
+    }
+    if (commitCallback_) {
+        commitCallback_(*committed.body, committed.qc);
+    }
+}
+
+const HotStuffEngine::CommittedBlock& HotStuffEngine::storeCommittedBlock(Block block) {
+    // Shard members commit the same heights; the first one writes the record
+    BlockLog* blockLog = BlockLog::getShardLog(blockLogPrefix_, block.shardID);
+    if (!blockLog && !blockLogPrefix_.empty()) {
+        // A configured log that cannot be written must not look like a persisted run
+        throw cRuntimeError("Cannot open the block log of shard %d at prefix %s",
+                            block.shardID, blockLogPrefix_.c_str());
+    }
+    if (blockLog && blockLog->append(block) == BlockLog::AppendResult::CONFLICT) {
+        log("Block log already holds another block at height " + std::to_string(block.height));
+    }
+    
+    // ...and holds the body the rest of the shard shares; the QC stays with this node
+    CommittedBlock committed;
+    committed.qc = std::move(block.qc);
+    committed.commitTime = simTime();
+    block.qc = QuorumCertificate();
+    committed.body = BlockStore::getGlobalInstance().intern(std::move(block));
+    committedBlocks_.push_back(std::move(committed));
+    if (committedBlocks_.size() > committedWindow_) {
+        committedBlocks_.pop_front();
+    }
+    return committedBlocks_.back();
+}
+
 } // namespace tribft
 
@@ -3,7 +3,15 @@
 
 #include <queue>
 #include <functional>
+#include <unordered_map>
+#include <memory>
 #include "../common/TriBFTDefs.h"
+#include "../common/IdGenerator.h"
+#include "../common/RingBuffer.h"
+#include "../blockchain/BlockStore.h"
+#include "SignatureAggregator.h"
+#include "VoteAccumulator.h"
+#include "VRFSelector.h"
 
 namespace tribft {
 
@@ -20,6 +28,12 @@ namespace tribft {
  * - KISS: Clear three-phase state machine
  * - YAGNI: Only implement core HotStuff features
  * 
+ * Chained mode (pipeline depth > 1): every block gets a single round of
+ * generic votes. The QC of height h is height h's PREPARE certificate,
+ * h-1's PRE-COMMIT certificate and h-2's COMMIT certificate, so a block
+ * commits once the two heights after it are certified. Up to pipelineDepth
+ * uncommitted heights may be in flight, each with its own vote accumulator.
+ * 
  * NOTE: This is a plain C++ class, NOT an OMNeT++ module.
  * Therefore, it cannot use EV_INFO or other OMNeT++ macros.
  * Logging is delegated to the caller (TriBFTApp).
@@ -29,9 +43,10 @@ public:
     // Callback types for delegation (Dependency Inversion)
     using ProposalCallback = std::function<void(const ConsensusProposal&)>;
     using VoteCallback = std::function<void(const VoteInfo&)>;
-    using CommitCallback = std::function<void(const Block&)>;
+    using CommitCallback = std::function<void(const Block&, const QuorumCertificate&)>; // shared body, own commit QC
     using LogCallback = std::function<void(const std::string&)>;
-    using PhaseAdvanceCallback = std::function<void(const std::string&, ConsensusPhase, ConsensusPhase)>; // proposalID, fromPhase, toPhase
+    using PhaseAdvanceCallback = std::function<void(MessageID, ConsensusPhase, ConsensusPhase)>; // proposalID, fromPhase, toPhase
+    using LatencyCallback = std::function<void(BlockHeight, simtime_t)>; // height, proposal-to-commit latency
     
     HotStuffEngine();
     ~HotStuffEngine() = default;
@@ -50,6 +65,57 @@ public:
      */
     void setShardSize(int size);
     
+    /**
+     * @brief Move the engine to another shard without rebuilding it
+     * 
+     * Drops the in-flight proposal, votes, the old shard's chain position
+     * and its consensus groups (install the new shard's with
+     * setConsensusGroup); callbacks, metrics and committed blocks are kept.
+     */
+    void switchShard(ShardID shardID);
+    
+    /**
+     * @brief Select classic (1) or chained (> 1) HotStuff
+     * @param depth Maximum number of uncommitted heights in flight
+     * 
+     * Only takes effect while no proposal is in flight. Depth 2 is raised
+     * to 3, the minimum at which the three-chain commit rule can fire.
+     */
+    void setPipelineDepth(int depth);
+    
+    /**
+     * @brief Install an elected consensus group as the QC voter slot space
+     * 
+     * Slots follow the group order (primary nodes, then redundant nodes),
+     * so every member builds and resolves bitmaps identically. Votes from
+     * nodes outside the group are rejected. The previous epoch's group is
+     * kept so QCs formed across a re-election still resolve. Until a
+     * non-empty group is installed (again, after switchShard), no vote
+     * is counted.
+     */
+    void setConsensusGroup(const ConsensusGroup& group);
+    
+    /**
+     * @brief Persist commits to the shard block logs and bound the in-memory copy
+     * @param logPrefix File prefix of the per-shard BlockLog (empty: no log;
+     *        a log that cannot be opened raises cRuntimeError on the first commit)
+     * @param window Committed blocks kept in memory (older ones are read back from the log)
+     */
+    void setCommittedBlockLog(const std::string& logPrefix, size_t window);
+    
+    /**
+     * @brief Replace the QC signature aggregator (default: simulated BLS)
+     */
+    void setSignatureAggregator(std::shared_ptr<SignatureAggregator> aggregator);
+    
+    /**
+     * @brief Draw proposal IDs from generator (default: a fresh one per initialize())
+     * 
+     * The owner keeps one generator per node so that a rebuilt engine does
+     * not reissue the IDs of its predecessor.
+     */
+    void setProposalIdGenerator(std::shared_ptr<IdGenerator> generator);
+    
     /**
      * @brief Set callbacks for external communication
      */
@@ -58,6 +124,7 @@ public:
     void setCommitCallback(CommitCallback callback);
     void setLogCallback(LogCallback callback);
     void setPhaseAdvanceCallback(PhaseAdvanceCallback callback);
+    void setLatencyCallback(LatencyCallback callback);
     
     // ========================================================================
     // CONSENSUS INTERFACE (Leader)
@@ -91,7 +158,7 @@ public:
     /**
      * @brief Handle phase advance message from leader (for follower nodes)
      */
-    void handlePhaseAdvance(const std::string& proposalID, ConsensusPhase toPhase);
+    void handlePhaseAdvance(MessageID proposalID, ConsensusPhase toPhase);
     
     /**
      * @brief Handle timeout event
@@ -106,14 +173,43 @@ public:
     ViewNumber getCurrentView() const { return currentView_; }
     BlockHeight getCurrentHeight() const { return currentHeight_; }
     
-    // Sync to specified height (lightweight sync)
-    void syncToHeight(BlockHeight newHeight);
+    /**
+     * @brief Adopt a height reached outside consensus (catch-up, see RangeSync)
+     * @param tipHash Hash of the block at newHeight; empty keeps previousBlockHash_
+     */
+    void syncToHeight(BlockHeight newHeight, const std::string& tipHash = "");
     
     const ConsensusProposal* getCurrentProposal() const;
+    
+    /**
+     * @brief Committed block at height: in-memory window first, then the block log
+     * @return Shared body (BlockStore, without QC), nullptr if unknown
+     */
+    BlockRef getCommittedBlock(BlockHeight height) const;
     const QuorumCertificate* getHighestQC() const;
     
+    /**
+     * @brief Resolve a QC's voter bitmap to node IDs
+     * @return Empty if the QC's epoch is neither the current nor the previous group's
+     */
+    std::vector<NodeID> getVoters(const QuorumCertificate& qc) const;
+    
     bool isInProgress() const;
     
+    bool isChained() const { return pipelineDepth_ > 1; }
+    
+    /**
+     * @brief Calculate quorum size (> 2/3)
+     */
+    int getQuorumSize() const;
+    int getPipelineDepth() const { return pipelineDepth_; }
+    size_t getInFlightCount() const { return pipeline_.size(); }
+    
+    /**
+     * @brief Proposals still holding a vote accumulator (pruned at the committed height)
+     */
+    size_t getOpenVoteCount() const { return votes_.size(); }
+    
     // ========================================================================
     // STATISTICS
     // ========================================================================
@@ -138,7 +234,7 @@ private:
     /**
      * @brief Check if we have quorum for current phase
      */
-    bool hasQuorum(const std::string& proposalID, ConsensusPhase phase);
+    bool hasQuorum(MessageID proposalID, ConsensusPhase phase);
     
     /**
      * @brief Advance to next phase
@@ -153,17 +249,46 @@ private:
     /**
      * @brief Generate unique proposal ID
      */
-    std::string generateProposalID();
+    MessageID generateProposalID();
     
     /**
-     * @brief Calculate quorum size (> 2/3)
+     * @brief Height the next proposal must carry (above all in-flight heights)
      */
-    int getQuorumSize() const;
+    BlockHeight getNextHeight() const;
     
     /**
      * @brief Create Quorum Certificate from votes
      */
-    QuorumCertificate createQC(const std::string& proposalID, ConsensusPhase phase);
+    QuorumCertificate createQC(MessageID proposalID, ConsensusPhase phase);
+    
+    /**
+     * @brief Add vote to its proposal's accumulator (INVALID if proposal unknown)
+     */
+    VoteAccumulator::AddResult recordVote(const VoteInfo& vote);
+    
+    /**
+     * @brief Drop accumulators of proposals at or below the committed height
+     */
+    void pruneVotes();
+    
+    /**
+     * @brief QC voter slot space of one elected consensus group
+     */
+    struct VoterGroup {
+        int epoch = Constants::NO_GROUP_EPOCH;
+        std::vector<NodeID> members;                  // Slot -> node (group order)
+        std::unordered_map<NodeID, int> slots;        // Node -> slot
+    };
+    
+    /**
+     * @brief Slot of voter in the epoch's QC bitmap (-1 if not a member)
+     */
+    int getVoterSlot(const NodeID& voterID, int epoch) const;
+    
+    /**
+     * @brief Elected group with that epoch (current or previous), nullptr if neither
+     */
+    const VoterGroup* findVoterGroup(int epoch) const;
     
     /**
      * @brief Reset consensus state for new round
@@ -175,6 +300,52 @@ private:
      */
     void log(const std::string& message);
     
+    // ========================================================================
+    // CHAINED MODE
+    // ========================================================================
+    
+    /**
+     * @brief One uncommitted height in chained mode
+     */
+    struct InFlightBlock {
+        ConsensusProposal proposal;
+        ConsensusPhase phase;      // PREPARE: collecting votes, PRE_COMMIT: certified, COMMIT: locked
+        QuorumCertificate qc;
+        simtime_t startTime;
+    };
+    
+    InFlightBlock* findInFlight(MessageID proposalID);
+    void handleChainedVote(const VoteInfo& vote);
+    
+    /**
+     * @brief Mark height as certified, lock its parent and commit what the chain allows
+     */
+    void certifyHeight(InFlightBlock& entry);
+    
+    /**
+     * @brief Commit lowest heights whose two successors are certified
+     */
+    void commitChain();
+    void commitInFlight(InFlightBlock& entry);
+    
+    /**
+     * @brief A commit as this node made it
+     */
+    struct CommittedBlock {
+        BlockRef body;             // Shared with the shard (BlockStore), no QC
+        QuorumCertificate qc;      // This node's commit QC (empty on followers)
+        simtime_t commitTime;
+    };
+    
+    /**
+     * @brief Append a commit to the block log and the in-memory window
+     *
+     * The log record keeps block.qc; the interned body drops it, so members
+     * that commit the same block share only what they all agree on.
+     * @return This node's commit (body shared with the rest of the shard)
+     */
+    const CommittedBlock& storeCommittedBlock(Block block);
+    
     // ========================================================================
     // PRIVATE DATA MEMBERS
     // ========================================================================
@@ -182,6 +353,7 @@ private:
     // Node identity
     NodeID nodeID_;
     ShardID shardID_;
+    std::shared_ptr<IdGenerator> proposalIDs_;
     int shardSize_;
     
     // Consensus state
@@ -194,15 +366,20 @@ private:
     ConsensusProposal currentProposal_;
     bool hasActiveProposal_;
     
-    // Vote collection (proposalID -> phase -> votes)
-    std::map<std::string, std::map<ConsensusPhase, std::vector<VoteInfo>>> voteStore_;
+    // Vote collection (proposalID -> per-phase tallies)
+    std::unordered_map<MessageID, VoteAccumulator> votes_;
     
     // Quorum Certificates
     QuorumCertificate highestQC_;
     std::map<ConsensusPhase, QuorumCertificate> phaseQCs_;
+    VoterGroup voterGroup_;                           // Current election's QC slot space
+    VoterGroup previousVoterGroup_;                   // Previous election's (QCs across a re-election)
+    std::shared_ptr<SignatureAggregator> aggregator_;
     
-    // Committed blocks
-    std::vector<Block> committedBlocks_;
+    // Committed blocks (latest committedWindow_ with shared bodies, all in the shard's BlockLog)
+    RingBuffer<CommittedBlock> committedBlocks_;
+    size_t committedWindow_;
+    std::string blockLogPrefix_;
     
     // Callbacks
     ProposalCallback proposalCallback_;
@@ -210,6 +387,12 @@ private:
     CommitCallback commitCallback_;
     LogCallback logCallback_;
     PhaseAdvanceCallback phaseAdvanceCallback_;
+    LatencyCallback latencyCallback_;
+    
+    // Chained mode (height -> uncommitted block)
+    int pipelineDepth_;
+    std::map<BlockHeight, InFlightBlock> pipeline_;
+    std::unordered_map<MessageID, BlockHeight> pipelineIndex_;    // proposalID -> height
     
     // Metrics
     ConsensusMetrics metrics_;
@@ -0,0 +1,34 @@
+#include "SignatureAggregator.h"
+
+namespace tribft {
+
+bool SignatureAggregator::verify(const AggregateSignature& aggregate,
+                                 const std::vector<std::string>& signatures) const {
+    AggregateSignature expected{};
+    for (const auto& signature : signatures) {
+        add(expected, signature);
+    }
+    return expected == aggregate;
+}
+
+void SimulatedBLSAggregator::add(AggregateSignature& aggregate, const std::string& signature) const {
+    // FNV-1a seed, then splitmix64 stream to fill the digest
+    uint64_t state = 14695981039346656037ULL;
+    for (unsigned char c : signature) {
+        state ^= c;
+        state *= 1099511628211ULL;
+    }
+    
+    for (size_t i = 0; i < aggregate.size(); i += 8) {
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        for (size_t b = 0; b < 8 && i + b < aggregate.size(); ++b) {
+            aggregate[i + b] ^= static_cast<uint8_t>(z >> (8 * b));
+        }
+    }
+}
+
+} // namespace tribft
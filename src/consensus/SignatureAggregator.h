@@ -0,0 +1,47 @@
+#ifndef SIGNATURE_AGGREGATOR_H
+#define SIGNATURE_AGGREGATOR_H
+
+#include <string>
+#include <vector>
+#include "../common/TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Folds voter signatures into one fixed-size QC signature
+ * 
+ * Implementations must be order-independent (like BLS point addition),
+ * so the same voter set always yields the same aggregate.
+ */
+class SignatureAggregator {
+public:
+    virtual ~SignatureAggregator() = default;
+    
+    /**
+     * @brief Add one voter's signature to the aggregate
+     */
+    virtual void add(AggregateSignature& aggregate, const std::string& signature) const = 0;
+    
+    /**
+     * @brief Check aggregate against the signatures of the claimed voters
+     * 
+     * Default: rebuild the aggregate and compare.
+     */
+    virtual bool verify(const AggregateSignature& aggregate,
+                        const std::vector<std::string>& signatures) const;
+};
+
+/**
+ * @brief Simulated BLS aggregation
+ * 
+ * Each signature is expanded to a 48-byte digest and XOR-folded into the
+ * aggregate: constant size, commutative and associative, no cryptography.
+ */
+class SimulatedBLSAggregator : public SignatureAggregator {
+public:
+    void add(AggregateSignature& aggregate, const std::string& signature) const override;
+};
+
+} // namespace tribft
+
+#endif // SIGNATURE_AGGREGATOR_H
@@ -1,4 +1,5 @@
 #include "VRFSelector.h"
+#include "../common/NodeRegistry.h"
 #include <algorithm>
 #include <sstream>
 #include <cmath>
@@ -16,7 +17,6 @@ void VRFSelector::initialize(ShardID shardID) {
     shardID_ = shardID;
     lastEpoch_ = -1;
     currentGroup_ = ConsensusGroup();
-    nodeRoles_.clear();
     
     log("VRFSelector initialized for shard " + std::to_string(shardID));
 }
@@ -41,25 +41,27 @@ ConsensusGroup VRFSelector::electConsensusGroup(
 }
 
 bool VRFSelector::isInConsensusGroup(const NodeID& nodeID) const {
-    for (const auto& node : currentGroup_.primaryNodes) {
-        if (node == nodeID) return true;
-    }
-    return false;
+    return isInConsensusGroup(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+bool VRFSelector::isInConsensusGroup(NodeIndex nodeIndex) const {
+    return currentGroup_.getRole(nodeIndex) == NodeRole::CONSENSUS_PRIMARY;
 }
 
 bool VRFSelector::isRedundantNode(const NodeID& nodeID) const {
-    for (const auto& node : currentGroup_.redundantNodes) {
-        if (node == nodeID) return true;
-    }
-    return false;
+    return isRedundantNode(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+bool VRFSelector::isRedundantNode(NodeIndex nodeIndex) const {
+    return currentGroup_.getRole(nodeIndex) == NodeRole::CONSENSUS_REDUNDANT;
 }
 
 NodeRole VRFSelector::getNodeRole(const NodeID& nodeID) const {
-    auto it = nodeRoles_.find(nodeID);
-    if (it != nodeRoles_.end()) {
-        return it->second;
-    }
-    return NodeRole::ORDINARY;
+    return getNodeRole(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+NodeRole VRFSelector::getNodeRole(NodeIndex nodeIndex) const {
+    return currentGroup_.getRole(nodeIndex);
 }
 
 // ============================================================================
@@ -77,13 +79,24 @@ void VRFSelector::updateEpoch(int epoch) {
 void VRFSelector::setCurrentGroup(const ConsensusGroup& group) {
     currentGroup_ = group;
     
-    // Synchronously update nodeRoles_ mapping
-    nodeRoles_.clear();
-    for (const NodeID& nodeID : group.primaryNodes) {
-        nodeRoles_[nodeID] = NodeRole::CONSENSUS_PRIMARY;
+    // Synchronously rebuild the role index
+    currentGroup_.buildIndex();
+}
+
+// ============================================================================
+// ConsensusGroup
+// ============================================================================
+
+void ConsensusGroup::buildIndex() {
+    NodeRegistry& registry = NodeRegistry::getGlobalInstance();
+    
+    roleIndex.clear();
+    roleIndex.reserve(primaryNodes.size() + redundantNodes.size());
+    for (const NodeID& nodeID : primaryNodes) {
+        roleIndex[registry.intern(nodeID)] = NodeRole::CONSENSUS_PRIMARY;
     }
-    for (const NodeID& nodeID : group.redundantNodes) {
-        nodeRoles_[nodeID] = NodeRole::CONSENSUS_REDUNDANT;
+    for (const NodeID& nodeID : redundantNodes) {
+        roleIndex[registry.intern(nodeID)] = NodeRole::CONSENSUS_REDUNDANT;
     }
 }
 
@@ -101,31 +114,53 @@ std::vector<NodeID> VRFSelector::selectTopN(
     int count,
     uint64_t seed) const
 {
-    if (candidates.empty()) {
+    if (candidates.empty() || count <= 0) {
         return {};
     }
     
     // Calculate VRF value for each candidate
-    std::vector<std::pair<double, NodeID>> vrfValues;
-    for (const auto& nodeID : candidates) {
-        double vrf = calculateVRF(nodeID, seed);
-        vrfValues.push_back({vrf, nodeID});
+    double* scores = topK_.prepare(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        scores[i] = calculateVRF(candidates[i], seed);
     }
     
-    // Sort by VRF value (descending)
-    std::sort(vrfValues.begin(), vrfValues.end(),
-        [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Select top N
+    // Partial selection of top N (descending VRF value)
     std::vector<NodeID> selected;
-    int selectCount = std::min(count, static_cast<int>(vrfValues.size()));
-    for (int i = 0; i < selectCount; ++i) {
-        selected.push_back(vrfValues[i].second);
+    for (uint32_t index : topK_.select(count)) {
+        selected.push_back(candidates[index]);
     }
     
     return selected;
 }
 
+std::vector<std::vector<NodeID>> VRFSelector::selectTopNBatch(
+    const std::vector<NodeID>& candidates,
+    int count,
+    const std::vector<uint64_t>& seeds) const
+{
+    std::vector<std::vector<NodeID>> selections(seeds.size());
+    if (candidates.empty() || count <= 0) {
+        return selections;
+    }
+    
+    // One pass over candidates, all seeds per candidate
+    const size_t n = candidates.size();
+    double* scores = topK_.prepare(n, seeds.size());
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t row = 0; row < seeds.size(); ++row) {
+            scores[row * n + i] = calculateVRF(candidates[i], seeds[row]);
+        }
+    }
+    
+    for (size_t row = 0; row < seeds.size(); ++row) {
+        for (uint32_t index : topK_.select(count, row)) {
+            selections[row].push_back(candidates[index]);
+        }
+    }
+    
+    return selections;
+}
+
 void VRFSelector::log(const std::string& message) const {
     if (logCallback_) {
         logCallback_("[VRF-Shard" + std::to_string(shardID_) + "] " + message);
@@ -3,8 +3,10 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include "../common/TriBFTDefs.h"
+#include "../common/TopKSelector.h"
 
 namespace tribft {
 
@@ -27,9 +29,26 @@ struct ConsensusGroup {
     int rsuCount;                        // Number of RSU nodes
     int vehicleCount;                    // Number of vehicle nodes
     int epoch;                           // Election epoch
+    std::unordered_map<NodeIndex, NodeRole> roleIndex;  // Membership index (see buildIndex)
     
     ConsensusGroup() : rsuCount(0), vehicleCount(0), epoch(0) {}
     
+    /**
+     * @brief Rebuild roleIndex from the member lists
+     * 
+     * Call once after the lists are filled (per election); role queries
+     * are then a single hash lookup on the interned node index.
+     */
+    void buildIndex();
+    
+    /**
+     * @brief Role of node in this group (ORDINARY if not a member)
+     */
+    NodeRole getRole(NodeIndex nodeIndex) const {
+        auto it = roleIndex.find(nodeIndex);
+        return it != roleIndex.end() ? it->second : NodeRole::ORDINARY;
+    }
+    
     /**
      * @brief Check RSU ratio constraint
      * Paper requirement: N_RSU >= N_total / 3
@@ -103,15 +122,30 @@ public:
         uint64_t seed = 0
     );
     
+    /**
+     * @brief Select top N candidates by VRF for several seeds at once
+     * 
+     * Scores every candidate for all seeds in one pass, then selects per seed.
+     * 
+     * @return One selection per seed, in seed order
+     */
+    std::vector<std::vector<NodeID>> selectTopNBatch(
+        const std::vector<NodeID>& candidates,
+        int count,
+        const std::vector<uint64_t>& seeds
+    ) const;
+    
     /**
      * @brief Check if node is in consensus group
      */
     bool isInConsensusGroup(const NodeID& nodeID) const;
+    bool isInConsensusGroup(NodeIndex nodeIndex) const;
     
     /**
      * @brief Check if node is a redundant node
      */
     bool isRedundantNode(const NodeID& nodeID) const;
+    bool isRedundantNode(NodeIndex nodeIndex) const;
     
     /**
      * @brief Get current consensus group
@@ -127,6 +161,7 @@ public:
      * @brief Get node role
      */
     NodeRole getNodeRole(const NodeID& nodeID) const;
+    NodeRole getNodeRole(NodeIndex nodeIndex) const;
     
     // ========================================================================
     // Rotation Management
@@ -155,7 +190,7 @@ private:
     double calculateVRF(const NodeID& nodeID, uint64_t seed) const;
     
     /**
-     * @brief Select N nodes from candidates
+     * @brief Select N nodes from candidates (highest VRF first)
      */
     std::vector<NodeID> selectTopN(
         const std::vector<NodeID>& candidates,
@@ -173,8 +208,8 @@ private:
     // ========================================================================
     
     ShardID shardID_;
-    ConsensusGroup currentGroup_;
-    std::map<NodeID, NodeRole> nodeRoles_;
+    ConsensusGroup currentGroup_;               // Indexed on every update (buildIndex)
+    mutable TopKSelector<double> topK_;         // Scratch for selectTopN
     int lastEpoch_;
     
     LogCallback logCallback_;
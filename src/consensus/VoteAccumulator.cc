@@ -0,0 +1,60 @@
+#include "VoteAccumulator.h"
+
+namespace tribft {
+
+VoteAccumulator::AddResult VoteAccumulator::add(ConsensusPhase phase, int voterSlot, bool approve,
+                                                const std::string& signature,
+                                                const SignatureAggregator& aggregator) {
+    int index = phaseIndex(phase);
+    if (index < 0 || voterSlot < 0 || static_cast<size_t>(voterSlot) >= VoterBitmap().size()) {
+        return AddResult::INVALID;
+    }
+    
+    PhaseTally& tally = phases_[index];
+    if (tally.voted.test(voterSlot)) {
+        return AddResult::DUPLICATE;
+    }
+    tally.voted.set(voterSlot);
+    
+    if (approve) {
+        tally.approved.set(voterSlot);
+        tally.approvals++;
+        aggregator.add(tally.signature, signature);
+    } else {
+        tally.rejections++;
+    }
+    return AddResult::ADDED;
+}
+
+int VoteAccumulator::getApprovals(ConsensusPhase phase) const {
+    int index = phaseIndex(phase);
+    return index < 0 ? 0 : phases_[index].approvals;
+}
+
+int VoteAccumulator::getRejections(ConsensusPhase phase) const {
+    int index = phaseIndex(phase);
+    return index < 0 ? 0 : phases_[index].rejections;
+}
+
+void VoteAccumulator::fillQC(ConsensusPhase phase, QuorumCertificate& qc) const {
+    int index = phaseIndex(phase);
+    if (index < 0) {
+        return;
+    }
+    const PhaseTally& tally = phases_[index];
+    qc.voters = tally.approved;
+    qc.signature = tally.signature;
+    qc.totalVotes = tally.approvals;
+    qc.epoch = epoch_;
+}
+
+int VoteAccumulator::phaseIndex(ConsensusPhase phase) {
+    switch (phase) {
+        case ConsensusPhase::PREPARE:    return 0;
+        case ConsensusPhase::PRE_COMMIT: return 1;
+        case ConsensusPhase::COMMIT:     return 2;
+        default:                         return -1;
+    }
+}
+
+} // namespace tribft
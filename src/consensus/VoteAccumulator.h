@@ -0,0 +1,75 @@
+#ifndef VOTE_ACCUMULATOR_H
+#define VOTE_ACCUMULATOR_H
+
+#include <array>
+#include "../common/TriBFTDefs.h"
+#include "SignatureAggregator.h"
+
+namespace tribft {
+
+/**
+ * @brief Votes collected for one proposal
+ * 
+ * One fixed slot per voting phase (PREPARE, PRE-COMMIT, COMMIT). Each slot
+ * keeps a voter bitset for duplicate detection, running approve/reject
+ * tallies and the aggregate signature of the approvals, so adding a vote,
+ * checking quorum and building a QC are all O(1) with no vote copies.
+ */
+class VoteAccumulator {
+public:
+    enum class AddResult {
+        ADDED,
+        DUPLICATE,   // Voter already voted in this phase
+        INVALID      // Not a voting phase or no voter slot
+    };
+    
+    /**
+     * @param epoch Consensus group election the voter slots refer to
+     */
+    explicit VoteAccumulator(BlockHeight height = 0, int epoch = Constants::NO_GROUP_EPOCH)
+        : height_(height), epoch_(epoch) {}
+    
+    /**
+     * @brief Record a vote
+     * @param voterSlot Voter's slot in the epoch's group (HotStuffEngine::getVoterSlot)
+     */
+    AddResult add(ConsensusPhase phase, int voterSlot, bool approve,
+                  const std::string& signature, const SignatureAggregator& aggregator);
+    
+    int getApprovals(ConsensusPhase phase) const;
+    int getRejections(ConsensusPhase phase) const;
+    
+    bool hasQuorum(ConsensusPhase phase, int quorumSize) const {
+        return getApprovals(phase) >= quorumSize;
+    }
+    
+    /**
+     * @brief Copy approving voters, aggregate signature and epoch into qc
+     */
+    void fillQC(ConsensusPhase phase, QuorumCertificate& qc) const;
+    
+    BlockHeight getHeight() const { return height_; }
+    int getEpoch() const { return epoch_; }
+    
+private:
+    struct PhaseTally {
+        VoterBitmap voted;
+        VoterBitmap approved;
+        AggregateSignature signature{};
+        int approvals = 0;
+        int rejections = 0;
+    };
+    
+    /**
+     * @brief PREPARE..COMMIT -> 0..2, anything else -> -1
+     */
+    static int phaseIndex(ConsensusPhase phase);
+    
+    std::array<PhaseTally, 3> phases_;
+    BlockHeight height_;
+    int epoch_;
+};
+
+} // namespace tribft
+
+#endif // VOTE_ACCUMULATOR_H
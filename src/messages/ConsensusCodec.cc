@@ -0,0 +1,640 @@
+#include "ConsensusCodec.h"
+#include <climits>
+#include <cstring>
+
+namespace tribft {
+
+namespace {
+    constexpr uint8_t kPhaseMask = 0x0F;
+    constexpr uint8_t kApproveFlag = 0x80;
+    constexpr int kMaxVarintBytes = 10;
+    constexpr size_t kVoterBytes = VoterBitmap().size() / 8;
+}
+
+ConsensusCodec::WireType ConsensusCodec::peekType(const Buffer& buffer) {
+    if (buffer.empty()) {
+        return WireType::NONE;
+    }
+    uint8_t tag = buffer[0];
+    if (tag < static_cast<uint8_t>(WireType::PROPOSAL) ||
+        tag > static_cast<uint8_t>(WireType::SYNC_CHECKPOINTS)) {
+        return WireType::NONE;
+    }
+    return static_cast<WireType>(tag);
+}
+
+// ============================================================================
+// Proposal
+// ============================================================================
+
+void ConsensusCodec::encodeProposal(const ConsensusProposal& proposal, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::PROPOSAL));
+    writeVarint(proposal.proposalID, out);
+    writeString(proposal.blockHash, out);
+    writeVarint(proposal.blockHeight, out);
+    writeVarint(proposal.viewNumber, out);
+    writeFixed32(proposal.shardID, out);
+    writeString(proposal.leaderID, out);
+    writeVarint(proposal.transactions.size(), out);
+}
+
+bool ConsensusCodec::decodeProposal(const Buffer& buffer, ConsensusProposal& proposal, uint32_t& txCount) {
+    if (peekType(buffer) != WireType::PROPOSAL) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint64_t height = 0;
+    uint64_t view = 0;
+    uint64_t count = 0;
+    int32_t shard = -1;
+    if (!reader.readVarint(proposal.proposalID) ||
+        !reader.readString(proposal.blockHash) ||
+        !reader.readVarint(height) ||
+        !reader.readVarint(view) ||
+        !reader.readFixed32(shard) ||
+        !reader.readString(proposal.leaderID) ||
+        !reader.readVarint(count) ||
+        !reader.atEnd()) {
+        return false;
+    }
+
+    proposal.blockHeight = height;
+    proposal.viewNumber = view;
+    proposal.shardID = shard;
+    txCount = static_cast<uint32_t>(count);
+    return true;
+}
+
+// ============================================================================
+// Vote
+// ============================================================================
+
+void ConsensusCodec::encodeVote(const VoteInfo& vote, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::VOTE));
+    writeVarint(vote.proposalID, out);
+
+    uint8_t flags = static_cast<uint8_t>(vote.phase) & kPhaseMask;
+    if (vote.approve) {
+        flags |= kApproveFlag;
+    }
+    out.push_back(flags);
+    writeString(vote.signature, out);
+}
+
+bool ConsensusCodec::decodeVote(const Buffer& buffer, VoteInfo& vote) {
+    if (peekType(buffer) != WireType::VOTE) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint8_t flags = 0;
+    if (!reader.readVarint(vote.proposalID) ||
+        !reader.readByte(flags) ||
+        !reader.readString(vote.signature) ||
+        !reader.atEnd()) {
+        return false;
+    }
+
+    uint8_t phase = flags & kPhaseMask;
+    if (!isValidPhase(phase)) {
+        return false;
+    }
+    vote.phase = static_cast<ConsensusPhase>(phase);
+    vote.approve = (flags & kApproveFlag) != 0;
+    return true;
+}
+
+// ============================================================================
+// Phase advance
+// ============================================================================
+
+void ConsensusCodec::encodePhaseAdvance(MessageID proposalID, ConsensusPhase fromPhase,
+                                        ConsensusPhase toPhase, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::PHASE_ADVANCE));
+    writeVarint(proposalID, out);
+    out.push_back(static_cast<uint8_t>(((static_cast<uint8_t>(fromPhase) & kPhaseMask) << 4) |
+                                       (static_cast<uint8_t>(toPhase) & kPhaseMask)));
+}
+
+bool ConsensusCodec::decodePhaseAdvance(const Buffer& buffer, MessageID& proposalID,
+                                        ConsensusPhase& fromPhase, ConsensusPhase& toPhase) {
+    if (peekType(buffer) != WireType::PHASE_ADVANCE) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint8_t phases = 0;
+    if (!reader.readVarint(proposalID) ||
+        !reader.readByte(phases) ||
+        !reader.atEnd()) {
+        return false;
+    }
+
+    uint8_t from = phases >> 4;
+    uint8_t to = phases & kPhaseMask;
+    if (!isValidPhase(from) || !isValidPhase(to)) {
+        return false;
+    }
+    fromPhase = static_cast<ConsensusPhase>(from);
+    toPhase = static_cast<ConsensusPhase>(to);
+    return true;
+}
+
+// ============================================================================
+// Sync request
+// ============================================================================
+
+void ConsensusCodec::encodeSyncRequest(const SyncRequest& request, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::SYNC_REQUEST));
+    writeVarint(request.requestID, out);
+    writeFixed32(request.shardID, out);
+    out.push_back(static_cast<uint8_t>(request.kind));
+    writeVarint(request.first, out);
+    writeVarint(request.count, out);
+    writeVarint(request.peer, out);
+}
+
+bool ConsensusCodec::decodeSyncRequest(const Buffer& buffer, SyncRequest& request) {
+    if (peekType(buffer) != WireType::SYNC_REQUEST) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint8_t kind = 0;
+    uint64_t first = 0;
+    uint64_t count = 0;
+    uint64_t peer = 0;
+    int32_t shard = -1;
+    if (!reader.readVarint(request.requestID) ||
+        !reader.readFixed32(shard) ||
+        !reader.readByte(kind) ||
+        !reader.readVarint(first) ||
+        !reader.readVarint(count) ||
+        !reader.readVarint(peer) ||
+        !reader.atEnd() ||
+        kind > static_cast<uint8_t>(SyncRangeKind::CHECKPOINTS) ||
+        count == 0 || count > UINT32_MAX || peer > UINT32_MAX) {
+        return false;
+    }
+
+    request.shardID = shard;
+    request.kind = static_cast<SyncRangeKind>(kind);
+    request.first = first;
+    request.count = static_cast<uint32_t>(count);
+    request.peer = static_cast<NodeIndex>(peer);
+    return true;
+}
+
+// ============================================================================
+// Sync responses
+// ============================================================================
+
+void ConsensusCodec::encodeSyncHeaders(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                       const std::vector<const BlockHeader*>& headers, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::SYNC_HEADERS));
+    writeVarint(requestID, out);
+    writeFixed32(shardID, out);
+    writeVarint(servedHeight, out);
+    writeVarint(headers.size(), out);
+    for (const BlockHeader* header : headers) {
+        writeHeader(*header, out);
+    }
+}
+
+bool ConsensusCodec::decodeSyncHeaders(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                       BlockHeight& servedHeight, std::vector<BlockHeader>& headers) {
+    if (peekType(buffer) != WireType::SYNC_HEADERS) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint64_t count = 0;
+    int32_t shard = -1;
+    if (!reader.readVarint(requestID) ||
+        !reader.readFixed32(shard) ||
+        !reader.readVarint(servedHeight) ||
+        !reader.readVarint(count)) {
+        return false;
+    }
+    shardID = shard;
+
+    // A forged count fails at the first item past the end of the buffer
+    headers.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        headers.emplace_back();
+        if (!readHeader(reader, headers.back())) {
+            return false;
+        }
+    }
+    return reader.atEnd();
+}
+
+void ConsensusCodec::encodeSyncBlocks(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                      const std::vector<const Block*>& blocks, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::SYNC_BLOCKS));
+    writeVarint(requestID, out);
+    writeFixed32(shardID, out);
+    writeVarint(servedHeight, out);
+    writeVarint(blocks.size(), out);
+    for (const Block* block : blocks) {
+        writeBlock(*block, out);
+    }
+}
+
+bool ConsensusCodec::decodeSyncBlocks(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                      BlockHeight& servedHeight, std::vector<Block>& blocks) {
+    if (peekType(buffer) != WireType::SYNC_BLOCKS) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint64_t count = 0;
+    int32_t shard = -1;
+    if (!reader.readVarint(requestID) ||
+        !reader.readFixed32(shard) ||
+        !reader.readVarint(servedHeight) ||
+        !reader.readVarint(count)) {
+        return false;
+    }
+    shardID = shard;
+
+    blocks.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        blocks.emplace_back();
+        if (!readBlock(reader, blocks.back())) {
+            return false;
+        }
+    }
+    return reader.atEnd();
+}
+
+void ConsensusCodec::encodeSyncCheckpoints(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                           const std::vector<CheckpointHeader>& path, Buffer& out) {
+    out.clear();
+    out.push_back(static_cast<uint8_t>(WireType::SYNC_CHECKPOINTS));
+    writeVarint(requestID, out);
+    writeFixed32(shardID, out);
+    writeVarint(servedHeight, out);
+    writeVarint(path.size(), out);
+    for (const CheckpointHeader& checkpoint : path) {
+        writeCheckpoint(checkpoint, out);
+    }
+}
+
+bool ConsensusCodec::decodeSyncCheckpoints(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                           BlockHeight& servedHeight, std::vector<CheckpointHeader>& path) {
+    if (peekType(buffer) != WireType::SYNC_CHECKPOINTS) {
+        return false;
+    }
+
+    Reader reader(buffer);
+    reader.pos = 1;
+
+    uint64_t count = 0;
+    int32_t shard = -1;
+    if (!reader.readVarint(requestID) ||
+        !reader.readFixed32(shard) ||
+        !reader.readVarint(servedHeight) ||
+        !reader.readVarint(count)) {
+        return false;
+    }
+    shardID = shard;
+
+    path.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        path.emplace_back();
+        if (!readCheckpoint(reader, path.back())) {
+            return false;
+        }
+    }
+    return reader.atEnd();
+}
+
+// ============================================================================
+// Chain items
+// ============================================================================
+
+void ConsensusCodec::writeHeader(const BlockHeader& header, Buffer& out) {
+    writeVarint(header.height, out);
+    writeString(header.blockHash, out);
+    writeString(header.previousHash, out);
+    writeHash(header.merkleRoot, out);
+    writeFixed32(header.shardID, out);
+    writeDouble(header.timestamp.dbl(), out);
+    writeString(header.proposer, out);
+    writeVarint(static_cast<uint64_t>(header.txCount), out);
+}
+
+bool ConsensusCodec::readHeader(Reader& reader, BlockHeader& header) {
+    uint64_t height = 0;
+    int32_t shard = -1;
+    double timestamp = 0.0;
+    uint64_t txCount = 0;
+    if (!reader.readVarint(height) ||
+        !reader.readString(header.blockHash) ||
+        !reader.readString(header.previousHash) ||
+        !reader.readHash(header.merkleRoot) ||
+        !reader.readFixed32(shard) ||
+        !reader.readDouble(timestamp) ||
+        !reader.readString(header.proposer) ||
+        !reader.readVarint(txCount) ||
+        txCount > INT32_MAX) {
+        return false;
+    }
+
+    header.height = height;
+    header.shardID = shard;
+    header.timestamp = timestamp;
+    header.txCount = static_cast<int>(txCount);
+    return true;
+}
+
+void ConsensusCodec::writeBlock(const Block& block, Buffer& out) {
+    writeVarint(block.height, out);
+    writeString(block.blockHash, out);
+    writeString(block.previousHash, out);
+    writeFixed32(block.shardID, out);
+    writeDouble(block.timestamp.dbl(), out);
+    writeString(block.proposer, out);
+    writeVarint(block.transactions.size(), out);
+    for (const Transaction& tx : block.transactions) {
+        writeString(tx.txID, out);
+        writeString(tx.sender, out);
+        writeString(tx.receiver, out);
+        writeDouble(tx.value, out);
+        writeDouble(tx.timestamp.dbl(), out);
+        writeString(tx.data, out);
+    }
+}
+
+bool ConsensusCodec::readBlock(Reader& reader, Block& block) {
+    uint64_t height = 0;
+    int32_t shard = -1;
+    double timestamp = 0.0;
+    uint64_t txCount = 0;
+    if (!reader.readVarint(height) ||
+        !reader.readString(block.blockHash) ||
+        !reader.readString(block.previousHash) ||
+        !reader.readFixed32(shard) ||
+        !reader.readDouble(timestamp) ||
+        !reader.readString(block.proposer) ||
+        !reader.readVarint(txCount)) {
+        return false;
+    }
+    block.height = height;
+    block.shardID = shard;
+    block.timestamp = timestamp;
+
+    block.transactions.clear();
+    for (uint64_t i = 0; i < txCount; ++i) {
+        Transaction tx;
+        double txTime = 0.0;
+        if (!reader.readString(tx.txID) ||
+            !reader.readString(tx.sender) ||
+            !reader.readString(tx.receiver) ||
+            !reader.readDouble(tx.value) ||
+            !reader.readDouble(txTime) ||
+            !reader.readString(tx.data)) {
+            return false;
+        }
+        tx.timestamp = txTime;
+        block.transactions.push_back(std::move(tx));
+    }
+    return true;
+}
+
+void ConsensusCodec::writeQC(const QuorumCertificate& qc, Buffer& out) {
+    writeVarint(qc.proposalID, out);
+    out.push_back(static_cast<uint8_t>(qc.phase));
+    writeVarint(qc.blockHeight, out);
+    writeVarint(qc.viewNumber, out);
+    writeVarint(static_cast<uint64_t>(qc.totalVotes), out);
+    writeVarint(static_cast<uint64_t>(qc.epoch - Constants::NO_GROUP_EPOCH), out);  // NO_GROUP_EPOCH -> 0
+    uint8_t voters[kVoterBytes] = {};
+    for (size_t slot = 0; slot < qc.voters.size(); ++slot) {
+        if (qc.voters.test(slot)) {
+            voters[slot / 8] |= static_cast<uint8_t>(1u << (slot % 8));
+        }
+    }
+    writeBytes(voters, sizeof(voters), out);
+    writeBytes(qc.signature.data(), qc.signature.size(), out);
+    writeDouble(qc.timestamp.dbl(), out);
+}
+
+bool ConsensusCodec::readQC(Reader& reader, QuorumCertificate& qc) {
+    uint8_t phase = 0;
+    uint64_t totalVotes = 0;
+    uint64_t epoch = 0;
+    uint8_t voters[kVoterBytes] = {};
+    double timestamp = 0.0;
+    if (!reader.readVarint(qc.proposalID) ||
+        !reader.readByte(phase) ||
+        !reader.readVarint(qc.blockHeight) ||
+        !reader.readVarint(qc.viewNumber) ||
+        !reader.readVarint(totalVotes) ||
+        !reader.readVarint(epoch) || epoch > static_cast<uint64_t>(INT_MAX) ||
+        !reader.readBytes(voters, sizeof(voters)) ||
+        !reader.readBytes(qc.signature.data(), qc.signature.size()) ||
+        !reader.readDouble(timestamp) ||
+        !isValidPhase(phase) || totalVotes > qc.voters.size()) {
+        return false;
+    }
+
+    qc.phase = static_cast<ConsensusPhase>(phase);
+    qc.totalVotes = static_cast<int>(totalVotes);
+    qc.epoch = static_cast<int>(epoch) + Constants::NO_GROUP_EPOCH;
+    qc.voters.reset();
+    for (size_t slot = 0; slot < qc.voters.size(); ++slot) {
+        if (voters[slot / 8] & (1u << (slot % 8))) {
+            qc.voters.set(slot);
+        }
+    }
+    qc.timestamp = timestamp;
+    return true;
+}
+
+void ConsensusCodec::writeCheckpoint(const CheckpointHeader& checkpoint, Buffer& out) {
+    writeVarint(checkpoint.height, out);
+    writeString(checkpoint.blockHash, out);
+    writeString(checkpoint.previousHash, out);
+    writeHash(checkpoint.merkleRoot, out);
+    writeFixed32(checkpoint.shardID, out);
+    writeString(checkpoint.proposer, out);
+    writeVarint(static_cast<uint64_t>(checkpoint.txCount), out);
+    writeQC(checkpoint.qc, out);
+    writeVarint(checkpoint.skipLinks.size(), out);
+    for (const Hash256& link : checkpoint.skipLinks) {
+        writeHash(link, out);
+    }
+}
+
+bool ConsensusCodec::readCheckpoint(Reader& reader, CheckpointHeader& checkpoint) {
+    uint64_t height = 0;
+    int32_t shard = -1;
+    uint64_t txCount = 0;
+    uint64_t links = 0;
+    if (!reader.readVarint(height) ||
+        !reader.readString(checkpoint.blockHash) ||
+        !reader.readString(checkpoint.previousHash) ||
+        !reader.readHash(checkpoint.merkleRoot) ||
+        !reader.readFixed32(shard) ||
+        !reader.readString(checkpoint.proposer) ||
+        !reader.readVarint(txCount) ||
+        !readQC(reader, checkpoint.qc) ||
+        !reader.readVarint(links) ||
+        txCount > INT32_MAX || links > 64) {
+        return false;
+    }
+
+    checkpoint.height = height;
+    checkpoint.shardID = shard;
+    checkpoint.txCount = static_cast<int>(txCount);
+    checkpoint.skipLinks.resize(static_cast<size_t>(links));
+    for (Hash256& link : checkpoint.skipLinks) {
+        if (!reader.readHash(link)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Primitive encoding
+// ============================================================================
+
+void ConsensusCodec::writeVarint(uint64_t value, Buffer& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void ConsensusCodec::writeFixed32(int32_t value, Buffer& out) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+void ConsensusCodec::writeString(const std::string& value, Buffer& out) {
+    writeVarint(value.size(), out);
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void ConsensusCodec::writeDouble(double value, Buffer& out) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+void ConsensusCodec::writeHash(const Hash256& value, Buffer& out) {
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void ConsensusCodec::writeBytes(const void* data, size_t length, Buffer& out) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + length);
+}
+
+bool ConsensusCodec::isValidPhase(uint8_t phase) {
+    return phase <= static_cast<uint8_t>(ConsensusPhase::COMMIT);
+}
+
+bool ConsensusCodec::Reader::readByte(uint8_t& value) {
+    if (pos >= size) {
+        return false;
+    }
+    value = data[pos++];
+    return true;
+}
+
+bool ConsensusCodec::Reader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < kMaxVarintBytes; ++i) {
+        uint8_t byte = 0;
+        if (!readByte(byte)) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;  // Overlong varint
+}
+
+bool ConsensusCodec::Reader::readFixed32(int32_t& value) {
+    if (pos > size || size - pos < 4) {
+        return false;
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<uint32_t>(data[pos++]) << (8 * i);
+    }
+    value = static_cast<int32_t>(bits);
+    return true;
+}
+
+bool ConsensusCodec::Reader::readDouble(double& value) {
+    if (pos > size || size - pos < 8) {
+        return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        bits |= static_cast<uint64_t>(data[pos++]) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool ConsensusCodec::Reader::readHash(Hash256& value) {
+    if (pos > size || size - pos < value.size()) {
+        return false;
+    }
+    std::memcpy(value.data(), data + pos, value.size());
+    pos += value.size();
+    return true;
+}
+
+bool ConsensusCodec::Reader::readBytes(void* out, size_t length) {
+    if (pos > size || size - pos < length) {
+        return false;
+    }
+    std::memcpy(out, data + pos, length);
+    pos += length;
+    return true;
+}
+
+bool ConsensusCodec::Reader::readString(std::string& value) {
+    uint64_t length = 0;
+    if (!readVarint(length) || length > size - pos) {
+        return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data + pos), static_cast<size_t>(length));
+    pos += static_cast<size_t>(length);
+    return true;
+}
+
+} // namespace tribft
@@ -0,0 +1,163 @@
+#ifndef CONSENSUS_CODEC_H
+#define CONSENSUS_CODEC_H
+
+#include <vector>
+#include <cstdint>
+#include "../common/TriBFTDefs.h"
+#include "../blockchain/LightweightSync.h"
+#include "../blockchain/SkipChain.h"
+
+namespace tribft {
+
+/**
+ * @brief Compact binary codec for disguised consensus payloads
+ *
+ * Proposals, votes, phase advances and catch-up traffic (RangeSync)
+ * travel inside TransactionMessage. Instead of pipe-delimited text they
+ * are encoded as:
+ *
+ *   [type:1][body...]
+ *
+ * - Integers that grow over a run (proposal ID, height, view, counts,
+ *   lengths) are LEB128 varints; shard IDs are fixed 4-byte little-endian.
+ * - Strings are varint length + raw bytes.
+ * - Vote phase/approve and phase-advance from/to share one flag byte.
+ * - Hashes (Hash256) are 32 raw bytes; times are 8-byte IEEE doubles.
+ * - QCs carry the group epoch (varint, offset so NO_GROUP_EPOCH is 0),
+ *   the voter bitmap (32 bytes) and signature (48 bytes) raw.
+ *
+ * The encoded size is exact, so it can be charged to the 802.11p frame.
+ * Decoders never read past the buffer and return false on malformed input.
+ */
+class ConsensusCodec {
+public:
+    using Buffer = std::vector<uint8_t>;
+
+    /**
+     * @brief One-byte type tag (first byte of every payload)
+     */
+    enum class WireType : uint8_t {
+        NONE = 0,
+        PROPOSAL = 1,
+        VOTE = 2,
+        PHASE_ADVANCE = 3,
+        SYNC_REQUEST = 4,
+        SYNC_HEADERS = 5,
+        SYNC_BLOCKS = 6,
+        SYNC_CHECKPOINTS = 7
+    };
+
+    /**
+     * @brief Get payload type without decoding it
+     */
+    static WireType peekType(const Buffer& buffer);
+
+    // ========================================================================
+    // Proposal: proposalID, blockHash, height, view, shard, leaderID, txCount
+    // ========================================================================
+
+    static void encodeProposal(const ConsensusProposal& proposal, Buffer& out);
+
+    /**
+     * @brief Decode proposal header (transactions are not carried)
+     * @param txCount Number of transactions announced by the leader
+     */
+    static bool decodeProposal(const Buffer& buffer, ConsensusProposal& proposal, uint32_t& txCount);
+
+    // ========================================================================
+    // Vote: proposalID, phase|approve, signature (voter = message sender)
+    // ========================================================================
+
+    static void encodeVote(const VoteInfo& vote, Buffer& out);
+    static bool decodeVote(const Buffer& buffer, VoteInfo& vote);
+
+    // ========================================================================
+    // Phase advance: proposalID, fromPhase|toPhase
+    // ========================================================================
+
+    static void encodePhaseAdvance(MessageID proposalID, ConsensusPhase fromPhase,
+                                   ConsensusPhase toPhase, Buffer& out);
+    static bool decodePhaseAdvance(const Buffer& buffer, MessageID& proposalID,
+                                   ConsensusPhase& fromPhase, ConsensusPhase& toPhase);
+
+    // ========================================================================
+    // Sync request: requestID, shardID, kind, first, count, peer (server NodeIndex)
+    // ========================================================================
+
+    static void encodeSyncRequest(const SyncRequest& request, Buffer& out);
+
+    /**
+     * @brief Decode request (RangeSync's retry state is local and not carried)
+     */
+    static bool decodeSyncRequest(const Buffer& buffer, SyncRequest& request);
+
+    // ========================================================================
+    // Sync responses: requestID, shardID (server's), servedHeight (server's
+    // latest header), items. Requester is the origin node of requestID
+    // (IdGenerator::getNode).
+    // ========================================================================
+
+    static void encodeSyncHeaders(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                  const std::vector<const BlockHeader*>& headers, Buffer& out);
+    static bool decodeSyncHeaders(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                  BlockHeight& servedHeight, std::vector<BlockHeader>& headers);
+
+    /**
+     * @brief Block bodies with transactions (the QC is not carried)
+     */
+    static void encodeSyncBlocks(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                 const std::vector<const Block*>& blocks, Buffer& out);
+    static bool decodeSyncBlocks(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                 BlockHeight& servedHeight, std::vector<Block>& blocks);
+
+    /**
+     * @brief Checkpoint proof, newest first (SkipChain::prove); empty if none
+     */
+    static void encodeSyncCheckpoints(MessageID requestID, ShardID shardID, BlockHeight servedHeight,
+                                      const std::vector<CheckpointHeader>& path, Buffer& out);
+    static bool decodeSyncCheckpoints(const Buffer& buffer, MessageID& requestID, ShardID& shardID,
+                                      BlockHeight& servedHeight, std::vector<CheckpointHeader>& path);
+
+private:
+    /**
+     * @brief Bounds-checked cursor over an encoded buffer
+     */
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t pos;
+
+        explicit Reader(const Buffer& b) : data(b.data()), size(b.size()), pos(0) {}
+
+        bool readByte(uint8_t& value);
+        bool readVarint(uint64_t& value);
+        bool readFixed32(int32_t& value);
+        bool readString(std::string& value);
+        bool readDouble(double& value);
+        bool readHash(Hash256& value);
+        bool readBytes(void* out, size_t length);
+        bool atEnd() const { return pos == size; }
+    };
+
+    static void writeVarint(uint64_t value, Buffer& out);
+    static void writeFixed32(int32_t value, Buffer& out);
+    static void writeString(const std::string& value, Buffer& out);
+    static void writeDouble(double value, Buffer& out);
+    static void writeHash(const Hash256& value, Buffer& out);
+    static void writeBytes(const void* data, size_t length, Buffer& out);
+
+    static void writeHeader(const BlockHeader& header, Buffer& out);
+    static bool readHeader(Reader& reader, BlockHeader& header);
+    static void writeBlock(const Block& block, Buffer& out);
+    static bool readBlock(Reader& reader, Block& block);
+    static void writeQC(const QuorumCertificate& qc, Buffer& out);
+    static bool readQC(Reader& reader, QuorumCertificate& qc);
+    static void writeCheckpoint(const CheckpointHeader& checkpoint, Buffer& out);
+    static bool readCheckpoint(Reader& reader, CheckpointHeader& checkpoint);
+
+    static bool isValidPhase(uint8_t phase);
+};
+
+} // namespace tribft
+
+#endif // CONSENSUS_CODEC_H
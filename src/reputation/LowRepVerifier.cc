@@ -1,12 +1,14 @@
 #include "LowRepVerifier.h"
+#include "../common/NodeRegistry.h"
 #include <algorithm>
-#include <sstream>
-#include <iomanip>
 
 namespace tribft {
 
 LowRepVerifier::LowRepVerifier()
-    : verifiersPerEvent_(3)
+    : resultRetention_(60.0)
+    , maxResults_(4096)
+    , nextRoundID_(1)
+    , verifiersPerEvent_(3)
     , threshold_(0.67)
 {
 }
@@ -26,18 +28,24 @@ void LowRepVerifier::setVerificationCallback(VerificationCallback callback) {
     verificationCallback_ = callback;
 }
 
+void LowRepVerifier::setResultRetention(double window, size_t maxResults) {
+    resultRetention_ = window;
+    maxResults_ = maxResults;
+    pruneResults(simTime());
+}
+
 // ============================================================================
 // Event Management
 // ============================================================================
 
-std::string LowRepVerifier::submitEvent(
+MessageID LowRepVerifier::submitEvent(
     const NodeID& reporterID,
     const std::string& eventType,
     const std::string& eventData,
     double reporterRep)
 {
     simtime_t now = simTime();
-    std::string eventID = generateEventID(reporterID, now);
+    MessageID eventID = generateEventID(reporterID);
     
     PendingEvent event;
     event.reporterID = reporterID;
@@ -48,15 +56,17 @@ std::string LowRepVerifier::submitEvent(
     event.reporterReputation = reporterRep;
     
     pendingEvents_[eventID] = event;
+    deadlines_.emplace(now, eventID);
+    unassigned_.push_back(eventID);
     
-    log("Event submitted: " + eventID + " from " + reporterID + 
+    log("Event submitted: " + IdGenerator::toString(eventID) + " from " + reporterID + 
         " (rep=" + std::to_string(reporterRep) + ")");
     
     return eventID;
 }
 
 std::vector<NodeID> LowRepVerifier::assignVerifiers(
-    const std::string& eventID,
+    MessageID eventID,
     const std::vector<NodeID>& trustedNodes,
     uint64_t seed)
 {
@@ -76,30 +86,188 @@ std::vector<NodeID> LowRepVerifier::assignVerifiers(
     // Select verifiers using VRF
     std::vector<NodeID> verifiers = selectVerifiers(candidates, verifiersPerEvent_, seed);
     
-    // Record task
-    VerificationTask task;
-    task.eventID = eventID;
-    task.verifiers = verifiers;
-    task.assignedTime = simTime();
-    tasks_[eventID] = task;
-    
-    log("Verifiers assigned for " + eventID + ": " + std::to_string(verifiers.size()) + " nodes");
+    recordTask(eventID, verifiers);
     
     return verifiers;
 }
 
+std::vector<std::vector<NodeID>> LowRepVerifier::assignVerifiers(
+    const std::vector<MessageID>& eventIDs,
+    const std::vector<NodeID>& trustedNodes,
+    const std::vector<uint64_t>& seeds)
+{
+    const size_t events = std::min(eventIDs.size(), seeds.size());
+    std::vector<std::vector<NodeID>> assignments(eventIDs.size());
+    if (trustedNodes.empty() || verifiersPerEvent_ <= 0) {
+        return assignments;
+    }
+    
+    // Score every trusted node once per seed
+    const size_t n = trustedNodes.size();
+    size_t* scores = topK_.prepare(n, events);
+    for (size_t row = 0; row < events; ++row) {
+        scoreCandidates(trustedNodes, seeds[row], scores + row * n);
+    }
+    
+    for (size_t row = 0; row < events; ++row) {
+        auto it = pendingEvents_.find(eventIDs[row]);
+        if (it == pendingEvents_.end()) {
+            continue;
+        }
+        
+        // One spare pick in case the reporter itself ranks among the winners
+        std::vector<NodeID>& verifiers = assignments[row];
+        for (uint32_t index : topK_.select(verifiersPerEvent_ + 1, row)) {
+            if (trustedNodes[index] == it->second.reporterID) {
+                continue;
+            }
+            if (static_cast<int>(verifiers.size()) == verifiersPerEvent_) {
+                break;
+            }
+            verifiers.push_back(trustedNodes[index]);
+        }
+        
+        recordTask(eventIDs[row], verifiers);
+    }
+    
+    return assignments;
+}
+
 void LowRepVerifier::submitVerification(
-    const std::string& eventID,
+    MessageID eventID,
     const NodeID& verifierID,
     bool confirm)
 {
     auto it = pendingEvents_.find(eventID);
     if (it == pendingEvents_.end()) {
-        log("ERROR: Event " + eventID + " not found");
+        if (results_.count(eventID)) {
+            log("Late verification from " + verifierID + " for " + IdGenerator::toString(eventID) + " ignored");
+        } else {
+            log("ERROR: Event " + IdGenerator::toString(eventID) + " not found");
+        }
         return;
     }
     
     PendingEvent& event = it->second;
+    countVote(event, confirm);
+    
+    log("Verification from " + verifierID + " for " + IdGenerator::toString(eventID) + ": " +
+        (confirm ? "CONFIRM" : "REJECT") + " (" + 
+        std::to_string(event.confirmCount) + "/" + 
+        std::to_string(event.rejectCount) + ")");
+    
+    tryComplete(it);
+}
+
+// ============================================================================
+// Batched Rounds
+// ============================================================================
+
+uint64_t LowRepVerifier::openRound(
+    const std::vector<NodeID>& trustedNodes,
+    uint64_t seed,
+    size_t maxEvents)
+{
+    VerificationRound round;
+    std::set<NodeID> reporters;
+    while (!unassigned_.empty() && round.eventIDs.size() < maxEvents) {
+        MessageID eventID = unassigned_.front();
+        unassigned_.pop_front();
+        
+        // Skip events that completed, expired or got a task individually
+        auto it = pendingEvents_.find(eventID);
+        if (it == pendingEvents_.end() || tasks_.count(eventID)) {
+            continue;
+        }
+        reporters.insert(it->second.reporterID);
+        round.eventIDs.push_back(eventID);
+    }
+    if (round.eventIDs.empty()) {
+        return 0;
+    }
+    
+    // No verifier may judge its own report
+    std::vector<NodeID> candidates;
+    for (const auto& nodeID : trustedNodes) {
+        if (!reporters.count(nodeID)) {
+            candidates.push_back(nodeID);
+        }
+    }
+    
+    round.roundID = nextRoundID_++;
+    round.verifiers = selectVerifiers(candidates, verifiersPerEvent_, seed);
+    round.responded.assign(round.verifiers.size(), false);
+    round.openedTime = simTime();
+    
+    VerificationTask task;
+    task.verifiers = round.verifiers;
+    task.assignedTime = round.openedTime;
+    for (MessageID eventID : round.eventIDs) {
+        task.eventID = eventID;
+        tasks_[eventID] = task;
+    }
+    
+    log("Round " + std::to_string(round.roundID) + " opened: " +
+        std::to_string(round.eventIDs.size()) + " events, " +
+        std::to_string(round.verifiers.size()) + " verifiers");
+    
+    uint64_t roundID = round.roundID;
+    rounds_[roundID] = std::move(round);
+    return roundID;
+}
+
+const VerificationRound* LowRepVerifier::getRound(uint64_t roundID) const {
+    auto it = rounds_.find(roundID);
+    return it != rounds_.end() ? &it->second : nullptr;
+}
+
+int LowRepVerifier::submitRoundVerdicts(
+    uint64_t roundID,
+    const NodeID& verifierID,
+    const VerificationRound::VerdictBitmap& verdicts)
+{
+    auto roundIt = rounds_.find(roundID);
+    if (roundIt == rounds_.end()) {
+        log("ERROR: Round " + std::to_string(roundID) + " not found");
+        return 0;
+    }
+    VerificationRound& round = roundIt->second;
+    
+    auto pos = std::find(round.verifiers.begin(), round.verifiers.end(), verifierID);
+    if (pos == round.verifiers.end()) {
+        log("ERROR: " + verifierID + " is not a verifier of round " + std::to_string(roundID));
+        return 0;
+    }
+    size_t verifierIndex = pos - round.verifiers.begin();
+    if (round.responded[verifierIndex]) {
+        return 0;
+    }
+    round.responded[verifierIndex] = true;
+    
+    int completed = 0;
+    int confirms = 0;
+    for (size_t i = 0; i < round.eventIDs.size(); ++i) {
+        // Events may have completed or expired since the round opened
+        auto it = pendingEvents_.find(round.eventIDs[i]);
+        if (it == pendingEvents_.end()) {
+            continue;
+        }
+        bool confirm = VerificationRound::getVerdict(verdicts, i);
+        confirms += confirm ? 1 : 0;
+        countVote(it->second, confirm);
+        completed += tryComplete(it) ? 1 : 0;
+    }
+    
+    log("Round " + std::to_string(roundID) + " verdicts from " + verifierID + ": " +
+        std::to_string(confirms) + " confirm, " + std::to_string(completed) + " completed");
+    
+    if (std::find(round.responded.begin(), round.responded.end(), false) == round.responded.end()) {
+        rounds_.erase(roundIt);
+    }
+    return completed;
+}
+
+void LowRepVerifier::countVote(PendingEvent& event, bool confirm) {
     event.verificationCount++;
     
     if (confirm) {
@@ -107,76 +275,84 @@ void LowRepVerifier::submitVerification(
     } else {
         event.rejectCount++;
     }
-    
-    log("Verification from " + verifierID + " for " + eventID + ": " +
-        (confirm ? "CONFIRM" : "REJECT") + " (" + 
-        std::to_string(event.confirmCount) + "/" + 
-        std::to_string(event.rejectCount) + ")");
+}
+
+bool LowRepVerifier::tryComplete(EventMap::iterator it) {
+    PendingEvent& event = it->second;
     
     // Check if verification threshold is reached
     if (checkVerificationThreshold(event)) {
+        MessageID eventID = it->first;
         // Verification complete
         event.verified = true;
         double confirmRatio = static_cast<double>(event.confirmCount) / 
                              event.verificationCount;
         event.result = (confirmRatio >= threshold_);
         
-        log(">>>VERIFICATION_COMPLETE<<< Event " + eventID + ": " +
+        log(">>>VERIFICATION_COMPLETE<<< Event " + IdGenerator::toString(eventID) + ": " +
             (event.result ? "TRUE" : "FALSE") + 
             " (ratio=" + std::to_string(confirmRatio) + ")");
         
+        bool result = event.result;
+        completeEvent(it);
+        
         // Callback notification
         if (verificationCallback_) {
-            verificationCallback_(eventID, event.result);
+            verificationCallback_(eventID, result);
         }
-        
-        // Cleanup verified events (optional: keep for statistics)
-        // pendingEvents_.erase(it);
-        // tasks_.erase(eventID);
+        return true;
     }
+    return false;
 }
 
-bool LowRepVerifier::isEventVerified(const std::string& eventID) const {
-    auto it = pendingEvents_.find(eventID);
-    if (it != pendingEvents_.end()) {
-        return it->second.verified;
-    }
-    return false;
+bool LowRepVerifier::isEventVerified(MessageID eventID) const {
+    return results_.count(eventID) > 0;
 }
 
-bool LowRepVerifier::getVerificationResult(const std::string& eventID) const {
-    auto it = pendingEvents_.find(eventID);
-    if (it != pendingEvents_.end() && it->second.verified) {
+bool LowRepVerifier::getVerificationResult(MessageID eventID) const {
+    auto it = results_.find(eventID);
+    if (it != results_.end()) {
         return it->second.result;
     }
     return false;
 }
 
 void LowRepVerifier::cleanupExpiredEvents(simtime_t currentTime, double timeout) {
-    std::vector<std::string> toRemove;
-    
-    for (const auto& pair : pendingEvents_) {
-        const PendingEvent& event = pair.second;
-        if (!event.verified && (currentTime - event.timestamp).dbl() > timeout) {
-            toRemove.push_back(pair.first);
+    while (!deadlines_.empty() && (currentTime - deadlines_.top().first).dbl() > timeout) {
+        Deadline deadline = deadlines_.top();
+        deadlines_.pop();
+        
+        // Already completed
+        auto it = pendingEvents_.find(deadline.second);
+        if (it == pendingEvents_.end()) {
+            continue;
         }
+        
+        log("Cleanup expired event: " + IdGenerator::toString(deadline.second));
+        pendingEvents_.erase(it);
+        tasks_.erase(deadline.second);
+    }
+    
+    // Expired rounds: their events are gone or will time out on their own.
+    // Round IDs are issued in opening order, so the oldest round is first
+    while (!rounds_.empty() && (currentTime - rounds_.begin()->second.openedTime).dbl() > timeout) {
+        rounds_.erase(rounds_.begin());
     }
     
-    for (const auto& eventID : toRemove) {
-        log("Cleanup expired event: " + eventID);
-        pendingEvents_.erase(eventID);
-        tasks_.erase(eventID);
+    // Drop queue heads that are no longer pending (queue is in submission order)
+    while (!unassigned_.empty() && !pendingEvents_.count(unassigned_.front())) {
+        unassigned_.pop_front();
     }
+    
+    pruneResults(currentTime);
 }
 
 // ============================================================================
 // Internal Methods
 // ============================================================================
 
-std::string LowRepVerifier::generateEventID(const NodeID& reporterID, simtime_t timestamp) {
-    std::ostringstream oss;
-    oss << "EVT_" << reporterID << "_" << std::fixed << std::setprecision(3) << timestamp.dbl();
-    return oss.str();
+MessageID LowRepVerifier::generateEventID(const NodeID& reporterID) {
+    return eventIDs_.nextFor(NodeRegistry::getGlobalInstance().intern(reporterID));
 }
 
 std::vector<NodeID> LowRepVerifier::selectVerifiers(
@@ -184,32 +360,62 @@ std::vector<NodeID> LowRepVerifier::selectVerifiers(
     int count,
     uint64_t seed)
 {
-    if (trustedNodes.empty()) {
+    if (trustedNodes.empty() || count <= 0) {
         return {};
     }
     
-    // Simplified VRF: hash-based sorting
-    std::vector<std::pair<size_t, NodeID>> scored;
-    std::hash<std::string> hasher;
+    // Simplified VRF: hash-based scores, partial selection of the top N
+    scoreCandidates(trustedNodes, seed, topK_.prepare(trustedNodes.size()));
     
-    for (const auto& nodeID : trustedNodes) {
-        std::string input = nodeID + std::to_string(seed);
-        size_t score = hasher(input);
-        scored.push_back({score, nodeID});
+    std::vector<NodeID> selected;
+    for (uint32_t index : topK_.select(count)) {
+        selected.push_back(trustedNodes[index]);
     }
     
-    // Sort by score
-    std::sort(scored.begin(), scored.end(),
-        [](const auto& a, const auto& b) { return a.first > b.first; });
+    return selected;
+}
+
+void LowRepVerifier::scoreCandidates(const std::vector<NodeID>& trustedNodes, uint64_t seed, size_t* scores) {
+    // Hash input is nodeID + decimal seed; reuse one buffer instead of a temporary per node
+    const std::string seedSuffix = std::to_string(seed);
+    std::hash<std::string> hasher;
     
-    // Select top N
-    std::vector<NodeID> selected;
-    int selectCount = std::min(count, static_cast<int>(scored.size()));
-    for (int i = 0; i < selectCount; ++i) {
-        selected.push_back(scored[i].second);
+    for (size_t i = 0; i < trustedNodes.size(); ++i) {
+        scoreInput_.assign(trustedNodes[i]);
+        scoreInput_.append(seedSuffix);
+        scores[i] = hasher(scoreInput_);
     }
+}
+
+void LowRepVerifier::recordTask(MessageID eventID, const std::vector<NodeID>& verifiers) {
+    VerificationTask task;
+    task.eventID = eventID;
+    task.verifiers = verifiers;
+    task.assignedTime = simTime();
+    tasks_[eventID] = task;
     
-    return selected;
+    log("Verifiers assigned for " + IdGenerator::toString(eventID) + ": " + std::to_string(verifiers.size()) + " nodes");
+}
+
+void LowRepVerifier::completeEvent(EventMap::iterator it) {
+    simtime_t now = simTime();
+    MessageID eventID = it->first;
+    
+    results_[eventID] = VerificationResult(now, it->second.result);
+    resultOrder_.emplace_back(now, eventID);
+    tasks_.erase(eventID);
+    pendingEvents_.erase(it);
+    
+    pruneResults(now);
+}
+
+void LowRepVerifier::pruneResults(simtime_t currentTime) {
+    while (!resultOrder_.empty() &&
+           (resultOrder_.size() > maxResults_ ||
+            (currentTime - resultOrder_.front().first).dbl() > resultRetention_)) {
+        results_.erase(resultOrder_.front().second);
+        resultOrder_.pop_front();
+    }
 }
 
 bool LowRepVerifier::checkVerificationThreshold(const PendingEvent& event) const {
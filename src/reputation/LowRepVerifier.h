@@ -2,10 +2,14 @@
 #define LOW_REP_VERIFIER_H
 
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <deque>
 #include <queue>
 #include <functional>
 #include "../common/TriBFTDefs.h"
+#include "../common/TopKSelector.h"
+#include "../common/IdGenerator.h"
 
 namespace tribft {
 
@@ -14,7 +18,7 @@ namespace tribft {
  */
 struct PendingEvent {
     NodeID reporterID;          // Reporter ID
-    std::string eventID;        // Event ID
+    MessageID eventID;          // Event ID (reporter index + sequence)
     std::string eventType;      // Event type
     std::string eventData;      // Event data
     simtime_t timestamp;        // Submission time
@@ -27,7 +31,7 @@ struct PendingEvent {
     bool verified;              // Whether verification is complete
     bool result;                // Verification result (true=authentic, false=false)
     
-    PendingEvent() : timestamp(0), reporterReputation(0.0),
+    PendingEvent() : eventID(Constants::INVALID_MESSAGE_ID), timestamp(0), reporterReputation(0.0),
                      verificationCount(0), confirmCount(0), 
                      rejectCount(0), verified(false), result(false) {}
 };
@@ -36,11 +40,54 @@ struct PendingEvent {
  * @brief Verification task
  */
 struct VerificationTask {
-    std::string eventID;
+    MessageID eventID;
     std::vector<NodeID> verifiers;  // Selected verifiers
     simtime_t assignedTime;         // Assignment time
     
-    VerificationTask() : assignedTime(0) {}
+    VerificationTask() : eventID(Constants::INVALID_MESSAGE_ID), assignedTime(0) {}
+};
+
+/**
+ * @brief Batched verification round
+ * 
+ * One verifier set covers every event of the round; each verifier answers
+ * with a single verdict bitmap (bit i = confirm eventIDs[i]).
+ */
+struct VerificationRound {
+    using VerdictBitmap = std::vector<uint64_t>;
+    
+    uint64_t roundID;
+    std::vector<MessageID> eventIDs;    // Bit order of the verdict bitmap
+    std::vector<NodeID> verifiers;      // Shared by all events of the round
+    std::vector<bool> responded;        // Per verifier
+    simtime_t openedTime;
+    
+    VerificationRound() : roundID(0), openedTime(0) {}
+    
+    /**
+     * @brief Empty bitmap sized for this round (all reject)
+     */
+    VerdictBitmap makeBitmap() const { return VerdictBitmap((eventIDs.size() + 63) / 64, 0); }
+    
+    static void setVerdict(VerdictBitmap& bits, size_t index, bool confirm) {
+        uint64_t mask = uint64_t(1) << (index % 64);
+        bits[index / 64] = confirm ? (bits[index / 64] | mask) : (bits[index / 64] & ~mask);
+    }
+    
+    static bool getVerdict(const VerdictBitmap& bits, size_t index) {
+        return index / 64 < bits.size() && ((bits[index / 64] >> (index % 64)) & 1);
+    }
+};
+
+/**
+ * @brief Outcome of a completed verification (kept after the event leaves the pool)
+ */
+struct VerificationResult {
+    simtime_t completedTime;    // Time the threshold was reached
+    bool result;                // true=authentic, false=false report
+    
+    VerificationResult() : completedTime(0), result(false) {}
+    VerificationResult(simtime_t time, bool authentic) : completedTime(time), result(authentic) {}
 };
 
 /**
@@ -52,6 +99,17 @@ struct VerificationTask {
  * - Collect verification results
  * - Feedback to reputation system
  * 
+ * Memory stays bounded: completed events leave the pool at once and only
+ * their result is retained (for resultRetention seconds, at most
+ * maxResults entries); unverified events leave it on timeout. Timeouts are
+ * found through a min-heap on submission time, so cleanup only touches
+ * expired events.
+ * 
+ * Batching: openRound() groups unassigned pending events into a round
+ * with one verifier set, and each verifier answers the whole round with
+ * submitRoundVerdicts(), i.e. one message per verifier instead of one per
+ * (event, verifier) pair.
+ * 
  * Paper mechanism:
  * - Events from low-rep nodes (R<0.2) require cross-verification
  * - Randomly select K verifiers from high-rep nodes (R>=0.8)
@@ -60,8 +118,9 @@ struct VerificationTask {
  */
 class LowRepVerifier {
 public:
+    using EventMap = std::unordered_map<MessageID, PendingEvent>;
     using LogCallback = std::function<void(const std::string&)>;
-    using VerificationCallback = std::function<void(const std::string&, bool)>;
+    using VerificationCallback = std::function<void(MessageID, bool)>;
     
     LowRepVerifier();
     ~LowRepVerifier() = default;
@@ -74,6 +133,13 @@ public:
     void setLogCallback(LogCallback callback);
     void setVerificationCallback(VerificationCallback callback);
     
+    /**
+     * @brief Configure result retention
+     * @param window Seconds a completed result stays queryable
+     * @param maxResults Upper bound on retained results (oldest dropped first)
+     */
+    void setResultRetention(double window, size_t maxResults);
+    
     // ========================================================================
     // Event Management
     // ========================================================================
@@ -86,7 +152,7 @@ public:
      * @param reporterRep Reporter's current reputation
      * @return Event ID
      */
-    std::string submitEvent(
+    MessageID submitEvent(
         const NodeID& reporterID,
         const std::string& eventType,
         const std::string& eventData,
@@ -101,11 +167,26 @@ public:
      * @return List of selected verifiers
      */
     std::vector<NodeID> assignVerifiers(
-        const std::string& eventID,
+        MessageID eventID,
         const std::vector<NodeID>& trustedNodes,
         uint64_t seed
     );
     
+    /**
+     * @brief Assign verification tasks for several events in one pass
+     * 
+     * Trusted nodes are scored for all seeds at once; each event then gets
+     * the same verifiers assignVerifiers(eventIDs[i], trustedNodes, seeds[i])
+     * would have chosen.
+     * 
+     * @return Selected verifiers per event (empty for unknown events)
+     */
+    std::vector<std::vector<NodeID>> assignVerifiers(
+        const std::vector<MessageID>& eventIDs,
+        const std::vector<NodeID>& trustedNodes,
+        const std::vector<uint64_t>& seeds
+    );
+    
     /**
      * @brief Submit verification result
      * @param eventID Event ID
@@ -113,21 +194,59 @@ public:
      * @param confirm Whether to confirm event authenticity
      */
     void submitVerification(
-        const std::string& eventID,
+        MessageID eventID,
         const NodeID& verifierID,
         bool confirm
     );
     
+    // ========================================================================
+    // Batched Rounds
+    // ========================================================================
+    
     /**
-     * @brief Check if event verification is complete
+     * @brief Group unassigned pending events (oldest first) into a round
+     * @param trustedNodes List of trusted nodes (R>=0.8)
+     * @param seed VRF seed
+     * @param maxEvents Round size limit
+     * @return Round ID, or 0 if there was nothing to assign
+     * 
+     * Verifiers are selected once per round among trusted nodes that report
+     * none of the round's events.
      */
-    bool isEventVerified(const std::string& eventID) const;
+    uint64_t openRound(
+        const std::vector<NodeID>& trustedNodes,
+        uint64_t seed,
+        size_t maxEvents
+    );
+    
+    /**
+     * @brief Get open round (nullptr if unknown or closed)
+     */
+    const VerificationRound* getRound(uint64_t roundID) const;
+    
+    /**
+     * @brief Submit one verifier's verdicts for a whole round
+     * @param verdicts Bit i confirms event i of the round
+     * @return Number of events completed by this submission
+     */
+    int submitRoundVerdicts(
+        uint64_t roundID,
+        const NodeID& verifierID,
+        const VerificationRound::VerdictBitmap& verdicts
+    );
+    
+    int getOpenRoundCount() const { return rounds_.size(); }
+    
+    /**
+     * @brief Check if event verification is complete (within the retention window)
+     */
+    bool isEventVerified(MessageID eventID) const;
     
     /**
      * @brief Get event verification result
      * @return true=authentic, false=false report
      */
-    bool getVerificationResult(const std::string& eventID) const;
+    bool getVerificationResult(MessageID eventID) const;
     
     /**
      * @brief Get pending event count
@@ -135,7 +254,16 @@ public:
     int getPendingCount() const { return pendingEvents_.size(); }
     
     /**
-     * @brief Cleanup expired events (verification timeout)
+     * @brief Get retained result count
+     */
+    int getResultCount() const { return results_.size(); }
+    
+    /**
+     * @brief Cleanup expired events (verification timeout) and results past retention
+     * 
+     * O(expired) heap pops; events already completed are skipped. Rounds
+     * open longer than timeout are closed, oldest first, stopping at the
+     * first one still within timeout.
      */
     void cleanupExpiredEvents(simtime_t currentTime, double timeout = 10.0);
     
@@ -145,9 +273,9 @@ private:
     // ========================================================================
     
     /**
-     * @brief Generate event ID
+     * @brief Generate event ID (unique per verifier, tagged with the reporter)
      */
-    std::string generateEventID(const NodeID& reporterID, simtime_t timestamp);
+    MessageID generateEventID(const NodeID& reporterID);
     
     /**
      * @brief Select verifiers using VRF
@@ -158,6 +286,34 @@ private:
         uint64_t seed
     );
     
+    /**
+     * @brief Fill one row of topK_ with VRF scores of trustedNodes for seed
+     */
+    void scoreCandidates(const std::vector<NodeID>& trustedNodes, uint64_t seed, size_t* scores);
+    
+    /**
+     * @brief Record task for event and log it
+     */
+    void recordTask(MessageID eventID, const std::vector<NodeID>& verifiers);
+    
+    void countVote(PendingEvent& event, bool confirm);
+    
+    /**
+     * @brief Complete the event if the verification threshold is reached
+     * @return true if the event completed (iterator is invalidated)
+     */
+    bool tryComplete(EventMap::iterator it);
+    
+    /**
+     * @brief Move completed event from the pool into the results cache
+     */
+    void completeEvent(EventMap::iterator it);
+    
+    /**
+     * @brief Drop results older than the retention window or above capacity
+     */
+    void pruneResults(simtime_t currentTime);
+    
     /**
      * @brief Check if verification threshold is reached
      */
@@ -172,8 +328,28 @@ private:
     // Data Members
     // ========================================================================
     
-    std::map<std::string, PendingEvent> pendingEvents_;    // Pending event pool
-    std::map<std::string, VerificationTask> tasks_;        // Verification tasks
+    EventMap pendingEvents_;                                    // Pending event pool
+    std::unordered_map<MessageID, VerificationTask> tasks_;     // Verification tasks
+    IdGenerator eventIDs_;
+    
+    // Submission deadlines, earliest first; entries of completed events are
+    // skipped when popped
+    using Deadline = std::pair<simtime_t, MessageID>;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    
+    // Completed results, in completion order for retention
+    std::unordered_map<MessageID, VerificationResult> results_;
+    std::deque<std::pair<simtime_t, MessageID>> resultOrder_;
+    double resultRetention_;    // Seconds a result is kept (default 60)
+    size_t maxResults_;         // Result cap (default 4096)
+    
+    // Batched rounds
+    std::deque<MessageID> unassigned_;                  // Submission order; stale IDs skipped
+    std::map<uint64_t, VerificationRound> rounds_;      // Open rounds (ID order = opening order)
+    uint64_t nextRoundID_;
+    
+    TopKSelector<size_t> topK_; // Scratch for verifier selection
+    std::string scoreInput_;    // Scratch for VRF hash input (nodeID + seed)
     
     int verifiersPerEvent_;     // Verifiers per event (default 3)
     double threshold_;          // Verification threshold (default 0.67, i.e., 2/3 majority)
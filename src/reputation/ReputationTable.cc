@@ -0,0 +1,329 @@
+#include "ReputationTable.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tribft {
+
+namespace {
+    // Independent accumulators per lane: lets the compiler keep a vector
+    // register per lane without reassociating floating-point sums
+    constexpr size_t kLanes = 4;
+
+    // Keys grow by 1/keep per tick since baseTick_; rescale well before
+    // they lose precision (0.99^512 ~ 0.006)
+    constexpr int64_t kRebaseTicks = 512;
+}
+
+ReputationTable::ReputationTable()
+    : keySum_(0.0), levelCounts_{0, 0, 0, 0},
+      weightModel_(Constants::DEFAULT_INTERACTION_WEIGHT),
+      target_(Constants::INITIAL_REPUTATION), keep_(1.0), baseTick_(0)
+{
+}
+
+// ============================================================================
+// SLOT MANAGEMENT
+// ============================================================================
+
+void ReputationTable::clear() {
+    nodes_.clear();
+    score_.clear();
+    global_.clear();
+    local_.clear();
+    weight_.clear();
+    final_.clear();
+    interactions_.clear();
+    lastUpdate_.clear();
+    decayTick_.clear();
+    rankKey_.clear();
+    level_.clear();
+    counters_.clear();
+    events_.clear();
+    slotOf_.clear();
+
+    rankIndex_.clear();
+    keySum_ = 0.0;
+    std::fill(levelCounts_, levelCounts_ + 4, 0);
+    baseTick_ = 0;
+}
+
+void ReputationTable::setDecayParameters(double target, double keep) {
+    clear();
+    target_ = target;
+    keep_ = keep;
+}
+
+void ReputationTable::setWeightLambda(double lambda) {
+    if (lambda == weightModel_.getLambda()) {
+        return;
+    }
+    weightModel_ = InteractionWeight(lambda);
+    for (uint32_t slot = 0; slot < nodes_.size(); ++slot) {
+        weight_[slot] = weightModel_(interactions_[slot]);
+        refreshFinal(slot);
+    }
+}
+
+uint32_t ReputationTable::insert(NodeIndex node, ReputationScore initialScore, double now, int64_t decayTick) {
+    if (node == Constants::INVALID_NODE_INDEX || find(node) != NO_SLOT) {
+        return NO_SLOT;
+    }
+    if (node >= slotOf_.size()) {
+        slotOf_.resize(node + 1, NO_SLOT);
+    }
+    rebaseIfNeeded(decayTick);
+
+    // Defaults match ReputationRecord(const NodeID&)
+    ReputationRecord defaults;
+    uint32_t slot = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(node);
+    score_.push_back(initialScore);
+    global_.push_back(defaults.globalReputation);
+    local_.push_back(defaults.localPerformance);
+    interactions_.push_back(defaults.localInteractionCount);
+    weight_.push_back(weightModel_(defaults.localInteractionCount));
+    final_.push_back(weight_.back() * defaults.globalReputation + (1.0 - weight_.back()) * defaults.localPerformance);
+    lastUpdate_.push_back(now);
+    decayTick_.push_back(decayTick);
+    rankKey_.push_back(rankKey(initialScore, decayTick));
+    level_.push_back(classify(final_.back()));
+    counters_.emplace_back();
+    events_.emplace_back();
+
+    slotOf_[node] = slot;
+
+    rankIndex_.emplace(rankKey_[slot], node);
+    keySum_ += rankKey_[slot];
+    ++levelCounts_[static_cast<size_t>(level_[slot])];
+    return slot;
+}
+
+bool ReputationTable::erase(NodeIndex node) {
+    uint32_t slot = find(node);
+    if (slot == NO_SLOT) {
+        return false;
+    }
+
+    rankIndex_.erase({rankKey_[slot], node});
+    keySum_ -= rankKey_[slot];
+    --levelCounts_[static_cast<size_t>(level_[slot])];
+
+    uint32_t last = static_cast<uint32_t>(nodes_.size() - 1);
+    if (slot != last) {
+        nodes_[slot] = nodes_[last];
+        score_[slot] = score_[last];
+        global_[slot] = global_[last];
+        local_[slot] = local_[last];
+        weight_[slot] = weight_[last];
+        final_[slot] = final_[last];
+        interactions_[slot] = interactions_[last];
+        lastUpdate_[slot] = lastUpdate_[last];
+        decayTick_[slot] = decayTick_[last];
+        rankKey_[slot] = rankKey_[last];
+        level_[slot] = level_[last];
+        counters_[slot] = counters_[last];
+        events_[slot] = events_[last];
+        slotOf_[nodes_[slot]] = slot;
+    }
+
+    nodes_.pop_back();
+    score_.pop_back();
+    global_.pop_back();
+    local_.pop_back();
+    weight_.pop_back();
+    final_.pop_back();
+    interactions_.pop_back();
+    lastUpdate_.pop_back();
+    decayTick_.pop_back();
+    rankKey_.pop_back();
+    level_.pop_back();
+    counters_.pop_back();
+    events_.pop_back();
+
+    slotOf_[node] = NO_SLOT;
+    return true;
+}
+
+// ============================================================================
+// COLUMN ACCESS
+// ============================================================================
+
+void ReputationTable::setScore(uint32_t slot, ReputationScore score) {
+    rebaseIfNeeded(decayTick_[slot]);
+
+    double key = rankKey(score, decayTick_[slot]);
+    if (key != rankKey_[slot]) {
+        NodeIndex node = nodes_[slot];
+        rankIndex_.erase({rankKey_[slot], node});
+        rankIndex_.emplace(key, node);
+        keySum_ += key - rankKey_[slot];
+        rankKey_[slot] = key;
+    }
+    score_[slot] = score;
+}
+
+void ReputationTable::setComponents(uint32_t slot, ReputationScore global, ReputationScore local, int interactions) {
+    global_[slot] = global;
+    local_[slot] = local;
+    if (interactions_[slot] != interactions) {
+        interactions_[slot] = interactions;
+        weight_[slot] = weightModel_(interactions);
+    }
+    refreshFinal(slot);
+}
+
+void ReputationTable::fillRecord(uint32_t slot, ReputationRecord& record) const {
+    const Counters& c = counters_[slot];
+    record.globalReputation = global_[slot];
+    record.localPerformance = local_[slot];
+    record.localInteractionCount = interactions_[slot];
+    record.finalReputation = final_[slot];
+    record.score = score_[slot];
+    record.successfulTx = c.successfulTx;
+    record.failedTx = c.failedTx;
+    record.validProposals = c.validProposals;
+    record.totalProposals = c.totalProposals;
+    record.correctVotes = c.correctVotes;
+    record.totalVotes = c.totalVotes;
+    record.lastUpdate = lastUpdate_[slot];
+    record.recentEvents = events_[slot];
+}
+
+// ============================================================================
+// DECAY
+// ============================================================================
+
+void ReputationTable::catchUp(uint32_t slot, const DecayStep& step) {
+    int64_t missed = step.tick - decayTick_[slot];
+    if (missed <= 0) {
+        return;
+    }
+
+    // Rank key is decay-invariant, so the index is left alone
+    double s = target_ + (score_[slot] - target_) * std::pow(keep_, static_cast<double>(missed));
+    score_[slot] = std::min(Constants::MAX_REPUTATION, std::max(Constants::MIN_REPUTATION, s));
+    decayTick_[slot] = step.tick;
+
+    // Eager decay stamped every tick; keep later event timestamps
+    lastUpdate_[slot] = std::max(lastUpdate_[slot], step.tickTime);
+}
+
+void ReputationTable::catchUpAll(const DecayStep& step) {
+    const size_t n = score_.size();
+
+    // Most slots missed the same number of ticks; reuse keep^k between them
+    int64_t lastMissed = 0;
+    double factor = 1.0;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t missed = step.tick - decayTick_[i];
+        if (missed <= 0) {
+            continue;
+        }
+        if (missed != lastMissed) {
+            lastMissed = missed;
+            factor = std::pow(keep_, static_cast<double>(missed));
+        }
+
+        double s = target_ + (score_[i] - target_) * factor;
+        score_[i] = std::min(Constants::MAX_REPUTATION, std::max(Constants::MIN_REPUTATION, s));
+        decayTick_[i] = step.tick;
+        lastUpdate_[i] = std::max(lastUpdate_[i], step.tickTime);
+    }
+}
+
+// ============================================================================
+// AGGREGATES
+// ============================================================================
+
+void ReputationTable::getTopNodes(size_t count, std::vector<NodeIndex>& out) const {
+    out.clear();
+    for (auto it = rankIndex_.begin(); it != rankIndex_.end() && out.size() < count; ++it) {
+        out.push_back(it->second);
+    }
+}
+
+ReputationScore ReputationTable::getAverageScore(int64_t tick) const {
+    return scoreAt(keySum_ / nodes_.size(), tick);
+}
+
+ReputationScore ReputationTable::getMinScore(int64_t tick) const {
+    return scoreAt(rankIndex_.rbegin()->first, tick);
+}
+
+ReputationScore ReputationTable::getMaxScore(int64_t tick) const {
+    return scoreAt(rankIndex_.begin()->first, tick);
+}
+
+ReputationTable::Level ReputationTable::classify(double finalReputation) {
+    if (finalReputation >= Constants::TRUSTED_REPUTATION_THRESHOLD) {
+        return Level::TRUSTED;
+    }
+    if (finalReputation >= Constants::STANDARD_REPUTATION_THRESHOLD) {
+        return Level::STANDARD;
+    }
+    return finalReputation > 0.0 ? Level::CANDIDATE : Level::NONE;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+double ReputationTable::rankKey(double score, int64_t decayTick) const {
+    return (score - target_) / std::pow(keep_, static_cast<double>(decayTick - baseTick_));
+}
+
+double ReputationTable::scoreAt(double key, int64_t tick) const {
+    double s = target_ + key * std::pow(keep_, static_cast<double>(tick - baseTick_));
+    return std::min(Constants::MAX_REPUTATION, std::max(Constants::MIN_REPUTATION, s));
+}
+
+void ReputationTable::setLevel(uint32_t slot, Level level) {
+    if (level_[slot] != level) {
+        --levelCounts_[static_cast<size_t>(level_[slot])];
+        ++levelCounts_[static_cast<size_t>(level)];
+        level_[slot] = level;
+    }
+}
+
+void ReputationTable::refreshFinal(uint32_t slot) {
+    final_[slot] = weight_[slot] * global_[slot] + (1.0 - weight_[slot]) * local_[slot];
+    setLevel(slot, classify(final_[slot]));
+}
+
+void ReputationTable::rebaseIfNeeded(int64_t tick) {
+    if (tick - baseTick_ <= kRebaseTicks) {
+        return;
+    }
+
+    // Scaling every key by the same positive factor keeps the ranking
+    const double factor = std::pow(keep_, static_cast<double>(tick - baseTick_));
+    const size_t n = rankKey_.size();
+    double* key = rankKey_.data();
+    for (size_t i = 0; i < n; ++i) {
+        key[i] *= factor;
+    }
+
+    RankIndex rescaled;
+    for (const auto& entry : rankIndex_) {
+        uint32_t slot = slotOf_[entry.second];
+        rescaled.emplace_hint(rescaled.end(), rankKey_[slot], entry.second);
+    }
+    rankIndex_.swap(rescaled);
+
+    // Resum exactly, dropping drift from incremental updates
+    double lane[kLanes] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            lane[l] += key[i + l];
+        }
+    }
+    keySum_ = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; i < n; ++i) {
+        keySum_ += key[i];
+    }
+
+    baseTick_ = tick;
+}
+
+} // namespace tribft
@@ -0,0 +1,243 @@
+#ifndef REPUTATION_TABLE_H
+#define REPUTATION_TABLE_H
+
+#include <vector>
+#include <set>
+#include <cstdint>
+#include "../common/TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Columnar (structure-of-arrays) storage for reputation records
+ *
+ * Each registered node owns a dense slot 0..size()-1. Hot fields (score,
+ * global/local components, interaction count, blend weight, cached final
+ * reputation, timestamp) live in separate contiguous arrays so whole-table
+ * passes (decay catch-up, rank rebase) are straight loops the compiler can
+ * vectorize. Rarely touched fields (counters, event history) are kept in
+ * side arrays with the same slot numbering.
+ *
+ * Removal swaps the last slot into the hole, so slots are not stable
+ * across unregister calls; key lookups go through find(NodeIndex).
+ *
+ * Score decay is lazy: each slot remembers the last decay tick applied to
+ * it and catchUp() applies the missing ticks in closed form.
+ *
+ * Aggregates are maintained on every write instead of rescanned:
+ * - Scores are ranked by key = (score - target) / keep^(tick - baseTick),
+ *   which decay does not change, so one ordered index serves top-N and
+ *   min/max at any tick, and sum(key) gives the average in O(1).
+ * - Per-level counts (trusted/standard/candidate by final reputation).
+ */
+class ReputationTable {
+public:
+    static constexpr uint32_t NO_SLOT = static_cast<uint32_t>(-1);
+
+    /**
+     * @brief Cold per-node statistics
+     */
+    struct Counters {
+        int successfulTx{0};
+        int failedTx{0};
+        int validProposals{0};
+        int totalProposals{0};
+        int correctVotes{0};
+        int totalVotes{0};
+    };
+
+    /**
+     * @brief Reputation level by final reputation (see ReputationRecord)
+     */
+    enum class Level : uint8_t {
+        NONE = 0,       // R <= 0
+        CANDIDATE = 1,  // 0 < R < 0.2
+        STANDARD = 2,   // 0.2 <= R < 0.8
+        TRUSTED = 3     // R >= 0.8
+    };
+    
+    /**
+     * @brief Decay state at the current time (see VRMManager)
+     * 
+     * Each tick moves score towards target: score = score * keep + target * (1 - keep).
+     * k ticks in closed form: score = target + (score - target) * keep^k.
+     */
+    struct DecayStep {
+        int64_t tick{0};        // Ticks since the decay epoch
+        double tickTime{0.0};   // Time of that tick (seconds)
+    };
+    
+    ReputationTable();
+    
+    // ========================================================================
+    // SLOT MANAGEMENT
+    // ========================================================================
+
+    void clear();
+    
+    /**
+     * @brief Set decay target and per-tick keep factor (clears the table)
+     */
+    void setDecayParameters(double target, double keep);
+    
+    /**
+     * @brief Set lambda of w = exp(-lambda * N_local) (refreshes all slots)
+     */
+    void setWeightLambda(double lambda);
+    
+    const InteractionWeight& getWeightModel() const { return weightModel_; }
+
+    /**
+     * @brief Add node with default components
+     * @param decayTick Current decay tick (earlier ticks do not apply to the node)
+     * @return New slot, or NO_SLOT if the node is already present
+     */
+    uint32_t insert(NodeIndex node, ReputationScore initialScore, double now, int64_t decayTick);
+
+    /**
+     * @brief Remove node (last slot is moved into its place)
+     */
+    bool erase(NodeIndex node);
+
+    /**
+     * @brief Get slot of node (NO_SLOT if absent)
+     */
+    uint32_t find(NodeIndex node) const {
+        return node < slotOf_.size() ? slotOf_[node] : NO_SLOT;
+    }
+
+    size_t size() const { return nodes_.size(); }
+    bool empty() const { return nodes_.empty(); }
+
+    // ========================================================================
+    // COLUMN ACCESS (by slot)
+    // ========================================================================
+
+    NodeIndex getNode(uint32_t slot) const { return nodes_[slot]; }
+
+    ReputationScore getScore(uint32_t slot) const { return score_[slot]; }
+    
+    /**
+     * @brief Overwrite score of a caught-up slot (updates rank index and sum)
+     */
+    void setScore(uint32_t slot, ReputationScore score);
+
+    ReputationScore getGlobal(uint32_t slot) const { return global_[slot]; }
+    ReputationScore getLocal(uint32_t slot) const { return local_[slot]; }
+    int getInteractionCount(uint32_t slot) const { return interactions_[slot]; }
+
+    /**
+     * @brief Set dual-model components (recomputes weight, final reputation and level)
+     */
+    void setComponents(uint32_t slot, ReputationScore global, ReputationScore local, int interactions);
+
+    /**
+     * @brief R_final = w * R_global + (1-w) * R_local (cached, refreshed by setComponents)
+     */
+    double getFinalReputation(uint32_t slot) const { return final_[slot]; }
+
+    double getLastUpdate(uint32_t slot) const { return lastUpdate_[slot]; }
+    void setLastUpdate(uint32_t slot, double now) { lastUpdate_[slot] = now; }
+
+    Counters& getCounters(uint32_t slot) { return counters_[slot]; }
+    EventHistory& getEvents(uint32_t slot) { return events_[slot]; }
+    const EventHistory& getEvents(uint32_t slot) const { return events_[slot]; }
+
+    /**
+     * @brief Materialize one slot as a ReputationRecord
+     */
+    void fillRecord(uint32_t slot, ReputationRecord& record) const;
+
+    // ========================================================================
+    // DECAY
+    // ========================================================================
+
+    /**
+     * @brief Apply decay ticks missed by one slot
+     */
+    void catchUp(uint32_t slot, const DecayStep& step);
+    
+    /**
+     * @brief Apply decay ticks missed by every slot
+     */
+    void catchUpAll(const DecayStep& step);
+
+    // ========================================================================
+    // AGGREGATES (maintained incrementally)
+    // ========================================================================
+
+    /**
+     * @brief Best count nodes by score, highest first (O(count))
+     */
+    void getTopNodes(size_t count, std::vector<NodeIndex>& out) const;
+
+    /**
+     * @brief Average / min / max score at decay tick (O(1); table must not be empty)
+     */
+    ReputationScore getAverageScore(int64_t tick) const;
+    ReputationScore getMinScore(int64_t tick) const;
+    ReputationScore getMaxScore(int64_t tick) const;
+
+    /**
+     * @brief Number of nodes at level (O(1))
+     */
+    size_t getLevelCount(Level level) const { return levelCounts_[static_cast<size_t>(level)]; }
+
+    static Level classify(double finalReputation);
+
+private:
+    /**
+     * @brief Ranking entry: descending key, ties by ascending node index
+     */
+    struct RankOrder {
+        bool operator()(const std::pair<double, NodeIndex>& a, const std::pair<double, NodeIndex>& b) const {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        }
+    };
+    using RankIndex = std::set<std::pair<double, NodeIndex>, RankOrder>;
+    
+    double rankKey(double score, int64_t decayTick) const;
+    double scoreAt(double key, int64_t tick) const;
+    void setLevel(uint32_t slot, Level level);
+    void refreshFinal(uint32_t slot);
+    
+    /**
+     * @brief Move baseTick_ forward (rescales all keys) before they grow too large
+     */
+    void rebaseIfNeeded(int64_t tick);
+    
+    // Hot columns
+    std::vector<NodeIndex> nodes_;
+    std::vector<double> score_;
+    std::vector<double> global_;
+    std::vector<double> local_;
+    std::vector<double> weight_;        // exp(-lambda * interactions)
+    std::vector<double> final_;         // Cached R_final
+    std::vector<int> interactions_;
+    std::vector<double> lastUpdate_;    // Seconds of simulation time
+    std::vector<int64_t> decayTick_;    // Last decay tick applied to score
+    std::vector<double> rankKey_;       // Decay-invariant score key
+    std::vector<Level> level_;
+
+    // Cold columns
+    std::vector<Counters> counters_;
+    std::vector<EventHistory> events_;
+
+    std::vector<uint32_t> slotOf_;      // NodeIndex -> slot
+    
+    // Aggregates
+    RankIndex rankIndex_;
+    double keySum_;
+    size_t levelCounts_[4];
+    
+    InteractionWeight weightModel_;
+    
+    // Decay parameters
+    double target_;
+    double keep_;
+    int64_t baseTick_;                  // Tick at which key == score - target
+};
+
+} // namespace tribft
+
+#endif // REPUTATION_TABLE_H
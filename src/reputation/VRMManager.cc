@@ -1,16 +1,46 @@
 #include "VRMManager.h"
 #include <algorithm>
+#include <cmath>
 
 namespace tribft {
 
-VRMManager::VRMManager() {
+VRMManager::VRMManager()
+    : table_(&ownTable_), decayInterval_(Constants::REPUTATION_DECAY_INTERVAL_SEC), decayEpoch_(0.0)
+{
 }
 
 void VRMManager::initialize() {
-    records_.clear();
+    table_ = &ownTable_;
+    ownTable_.setDecayParameters(Constants::INITIAL_REPUTATION, 1.0 - Constants::REPUTATION_DECAY_RATE);
+    localOverlay_.clear();
+    decayEpoch_ = SIMTIME_DBL(simTime());
     log("VRM Manager initialized");
 }
 
+void VRMManager::setDecayInterval(double seconds) {
+    decayInterval_ = seconds;
+}
+
+void VRMManager::setWeightLambda(double lambda) {
+    table_->setWeightLambda(lambda);
+}
+
+void VRMManager::useSharedStore() {
+    ownTable_.clear();
+    table_ = &getSharedTable();
+    decayEpoch_ = 0.0;  // One decay clock for the whole simulation
+    log("Using shared reputation store (" + std::to_string(table_->size()) + " nodes)");
+}
+
+ReputationTable& VRMManager::getSharedTable() {
+    static ReputationTable shared = [] {
+        ReputationTable table;
+        table.setDecayParameters(Constants::INITIAL_REPUTATION, 1.0 - Constants::REPUTATION_DECAY_RATE);
+        return table;
+    }();
+    return shared;
+}
+
 void VRMManager::setLogCallback(LogCallback callback) {
     logCallback_ = callback;
 }
@@ -20,29 +50,32 @@ void VRMManager::setLogCallback(LogCallback callback) {
 // ============================================================================
 
 void VRMManager::registerNode(const NodeID& nodeID, ReputationScore initialScore) {
-    if (records_.find(nodeID) != records_.end()) {
-        log("Node " + nodeID + " already registered");
+    NodeIndex nodeIndex = NodeRegistry::getGlobalInstance().intern(nodeID);
+    if (table_->insert(nodeIndex, clampReputation(initialScore), SIMTIME_DBL(simTime()), getDecayStep().tick) == ReputationTable::NO_SLOT) {
+        // Expected in shared mode: another node registered it first
+        if (!isShared()) {
+            log("Node " + nodeID + " already registered");
+        }
         return;
     }
     
-    ReputationRecord record(nodeID);
-    record.score = clampReputation(initialScore);
-    record.lastUpdate = simTime();
-    
-    records_[nodeID] = record;
     log("Registered node " + nodeID + " with initial reputation " + std::to_string(initialScore));
 }
 
 void VRMManager::unregisterNode(const NodeID& nodeID) {
-    auto it = records_.find(nodeID);
-    if (it != records_.end()) {
-        records_.erase(it);
+    NodeIndex nodeIndex = NodeRegistry::getGlobalInstance().find(nodeID);
+    if (isShared()) {
+        // Shared record outlives this view; only forget local observations
+        localOverlay_.erase(nodeIndex);
+        return;
+    }
+    if (table_->erase(nodeIndex)) {
         log("Unregistered node " + nodeID);
     }
 }
 
 bool VRMManager::isRegistered(const NodeID& nodeID) const {
-    return records_.find(nodeID) != records_.end();
+    return findSlot(nodeID) != ReputationTable::NO_SLOT;
 }
 
 // ============================================================================
@@ -50,61 +83,72 @@ bool VRMManager::isRegistered(const NodeID& nodeID) const {
 // ============================================================================
 
 ReputationScore VRMManager::getReputation(const NodeID& nodeID) const {
-    auto it = records_.find(nodeID);
-    if (it != records_.end()) {
-        return it->second.score;
+    uint32_t slot = touchSlot(nodeID);
+    if (slot != ReputationTable::NO_SLOT) {
+        return table_->getScore(slot);
     }
     return Constants::INITIAL_REPUTATION;
 }
 
-const ReputationRecord* VRMManager::getRecord(const NodeID& nodeID) const {
-    auto it = records_.find(nodeID);
-    if (it != records_.end()) {
-        return &(it->second);
+bool VRMManager::getRecord(const NodeID& nodeID, ReputationRecord& record) const {
+    uint32_t slot = touchSlot(nodeID);
+    if (slot == ReputationTable::NO_SLOT) {
+        return false;
+    }
+    record.nodeID = nodeID;
+    table_->fillRecord(slot, record);
+    if (isShared()) {
+        auto it = localOverlay_.find(table_->getNode(slot));
+        LocalObservation local = it != localOverlay_.end() ? it->second : LocalObservation();
+        record.localPerformance = local.performance;
+        record.localInteractionCount = local.interactions;
+        record.finalReputation = getFinalReputation(slot);
+    }
+    return true;
+}
+
+int VRMManager::getRecentFailureCount(const NodeID& nodeID, simtime_t window) const {
+    uint32_t slot = findSlot(nodeID);
+    if (slot == ReputationTable::NO_SLOT) {
+        return 0;
     }
-    return nullptr;
+    return static_cast<int>(table_->getEvents(slot).countFailuresSince(simTime() - window));
 }
 
 bool VRMManager::isReliable(const NodeID& nodeID) const {
-    auto it = records_.find(nodeID);
-    if (it != records_.end()) {
-        return it->second.isReliable();
+    uint32_t slot = findSlot(nodeID);
+    if (slot != ReputationTable::NO_SLOT) {
+        return getFinalReputation(slot) >= Constants::TRUSTED_REPUTATION_THRESHOLD;
     }
     return false;
 }
 
 std::vector<NodeID> VRMManager::getTopNodes(int count) const {
-    // Create sorted list of (nodeID, reputation) pairs
-    std::vector<std::pair<NodeID, ReputationScore>> nodes;
-    for (const auto& pair : records_) {
-        nodes.push_back({pair.first, pair.second.score});
+    if (table_->empty() || count <= 0) {
+        return {};
     }
     
-    // Sort by reputation (descending)
-    std::sort(nodes.begin(), nodes.end(),
-        [](const auto& a, const auto& b) { return a.second > b.second; });
+    // Rank index is kept sorted by score (decay does not reorder it)
+    std::vector<NodeIndex> top;
+    table_->getTopNodes(count, top);
     
-    // Extract top N node IDs
+    // Names resolved only for the result
+    const NodeRegistry& registry = NodeRegistry::getGlobalInstance();
     std::vector<NodeID> result;
-    int n = std::min(count, static_cast<int>(nodes.size()));
-    for (int i = 0; i < n; i++) {
-        result.push_back(nodes[i].first);
+    result.reserve(top.size());
+    for (NodeIndex node : top) {
+        result.push_back(registry.getName(node));
     }
     
     return result;
 }
 
 ReputationScore VRMManager::getAverageReputation() const {
-    if (records_.empty()) {
+    if (table_->empty()) {
         return Constants::INITIAL_REPUTATION;
     }
     
-    double sum = 0.0;
-    for (const auto& pair : records_) {
-        sum += pair.second.score;
-    }
-    
-    return sum / records_.size();
+    return table_->getAverageScore(getDecayStep().tick);
 }
 
 // ============================================================================
@@ -112,19 +156,19 @@ ReputationScore VRMManager::getAverageReputation() const {
 // ============================================================================
 
 void VRMManager::recordEvent(const NodeID& nodeID, ReputationEvent event) {
-    auto it = records_.find(nodeID);
-    if (it == records_.end()) {
+    uint32_t slot = touchSlot(nodeID);
+    if (slot == ReputationTable::NO_SLOT) {
         log("Cannot record event for unregistered node " + nodeID);
         return;
     }
     
-    ReputationRecord& record = it->second;
-    record.recentEvents.push_back(event);
-    record.lastUpdate = simTime();
+    ReputationTable::Counters& record = table_->getCounters(slot);
+    table_->getEvents(slot).push(event, simTime());
+    table_->setLastUpdate(slot, SIMTIME_DBL(simTime()));
     
     // Apply marginal diminishing reward mechanism
     EventWeight weight = getEventWeight(event);
-    double currentRep = record.getFinalReputation();
+    double currentRep = getFinalReputation(slot);
     double alpha = weight.getEffectiveWeight(currentRep);
     
     // Determine delta direction based on event type
@@ -237,32 +281,16 @@ void VRMManager::penalizeForMalicious(const NodeID& nodeID) {
 // ============================================================================
 
 void VRMManager::applyDecay() {
-    for (auto& pair : records_) {
-        ReputationRecord& record = pair.second;
-        
-        // Apply decay: move reputation slightly towards initial value
-        double target = Constants::INITIAL_REPUTATION;
-        double decayRate = Constants::REPUTATION_DECAY_RATE;
-        record.score = record.score * (1.0 - decayRate) + target * decayRate;
-        
-        record.score = clampReputation(record.score);
-        record.lastUpdate = simTime();
-    }
+    ReputationTable::DecayStep step = getDecayStep();
+    table_->catchUpAll(step);
     
-    log("Applied reputation decay to " + std::to_string(records_.size()) + " nodes");
+    log("Applied reputation decay to " + std::to_string(table_->size()) + " nodes (tick " + std::to_string(step.tick) + ")");
 }
 
 void VRMManager::cleanupHistory(int maxEventsPerNode) {
-    for (auto& pair : records_) {
-        ReputationRecord& record = pair.second;
-        
-        if (record.recentEvents.size() > static_cast<size_t>(maxEventsPerNode)) {
-            // Keep only recent events
-            record.recentEvents.erase(
-                record.recentEvents.begin(),
-                record.recentEvents.begin() + (record.recentEvents.size() - maxEventsPerNode)
-            );
-        }
+    // History is already bounded (EventHistory::CAPACITY); this only shortens it
+    for (uint32_t slot = 0; slot < table_->size(); ++slot) {
+        table_->getEvents(slot).keepLast(static_cast<size_t>(std::max(0, maxEventsPerNode)));
     }
 }
 
@@ -271,40 +299,29 @@ void VRMManager::cleanupHistory(int maxEventsPerNode) {
 // ============================================================================
 
 int VRMManager::getReliableNodeCount() const {
-    int count = 0;
-    for (const auto& pair : records_) {
-        if (pair.second.isReliable()) {
-            count++;
-        }
-    }
-    return count;
+    return getNodeCountAtLevel(ReputationTable::Level::TRUSTED);
+}
+
+int VRMManager::getNodeCountAtLevel(ReputationTable::Level level) const {
+    return static_cast<int>(table_->getLevelCount(level));
 }
 
 VRMManager::Statistics VRMManager::getStatistics() const {
     Statistics stats;
-    stats.totalNodes = records_.size();
+    stats.totalNodes = table_->size();
     
-    if (records_.empty()) {
+    if (table_->empty()) {
         return stats;
     }
     
-    double sum = 0.0;
-    stats.maxScore = Constants::MIN_REPUTATION;
-    stats.minScore = Constants::MAX_REPUTATION;
-    
-    for (const auto& pair : records_) {
-        ReputationScore score = pair.second.score;
-        sum += score;
-        
-        if (score > stats.maxScore) stats.maxScore = score;
-        if (score < stats.minScore) stats.minScore = score;
-        
-        if (pair.second.isReliable()) {
-            stats.reliableNodes++;
-        }
-    }
-    
-    stats.averageScore = sum / records_.size();
+    // All maintained incrementally (O(1))
+    int64_t tick = getDecayStep().tick;
+    stats.reliableNodes = getNodeCountAtLevel(ReputationTable::Level::TRUSTED);
+    stats.standardNodes = getNodeCountAtLevel(ReputationTable::Level::STANDARD);
+    stats.candidateNodes = getNodeCountAtLevel(ReputationTable::Level::CANDIDATE);
+    stats.maxScore = table_->getMaxScore(tick);
+    stats.minScore = table_->getMinScore(tick);
+    stats.averageScore = table_->getAverageScore(tick);
     
     return stats;
 }
@@ -322,6 +339,57 @@ void VRMManager::updateScore(const NodeID& nodeID, double delta) {
     // TODO: Core implementation hidden - will be released after project completion
 }
 
+double VRMManager::getFinalReputation(uint32_t slot) const {
+    if (!isShared()) {
+        return table_->getFinalReputation(slot);
+    }
+    
+    // Shared record carries R_global; R_local / N_local come from this node's overlay
+    auto it = localOverlay_.find(table_->getNode(slot));
+    if (it == localOverlay_.end()) {
+        return table_->getGlobal(slot);  // N_local = 0 -> w = 1
+    }
+    double w = table_->getWeightModel()(it->second.interactions);
+    return w * table_->getGlobal(slot) + (1.0 - w) * it->second.performance;
+}
+
+void VRMManager::setLocalObservation(uint32_t slot, ReputationScore performance, int interactions) {
+    if (!isShared()) {
+        table_->setComponents(slot, table_->getGlobal(slot), performance, interactions);
+        return;
+    }
+    LocalObservation& local = localOverlay_[table_->getNode(slot)];
+    local.performance = performance;
+    local.interactions = interactions;
+}
+
+uint32_t VRMManager::findSlot(const NodeID& nodeID) const {
+    return table_->find(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+uint32_t VRMManager::touchSlot(const NodeID& nodeID) const {
+    uint32_t slot = findSlot(nodeID);
+    if (slot != ReputationTable::NO_SLOT) {
+        table_->catchUp(slot, getDecayStep());
+    }
+    return slot;
+}
+
+ReputationTable::DecayStep VRMManager::getDecayStep() const {
+    ReputationTable::DecayStep step;
+    if (decayInterval_ <= 0.0) {
+        return step;
+    }
+    
+    // Eager decay ran at epoch + k * interval for k = 1, 2, ...
+    double elapsed = SIMTIME_DBL(simTime()) - decayEpoch_;
+    if (elapsed > 0.0) {
+        step.tick = static_cast<int64_t>(std::floor(elapsed / decayInterval_));
+    }
+    step.tickTime = decayEpoch_ + step.tick * decayInterval_;
+    return step;
+}
+
 ReputationScore VRMManager::clampReputation(ReputationScore score) const {
     if (score < Constants::MIN_REPUTATION) {
         return Constants::MIN_REPUTATION;
@@ -1,9 +1,11 @@
 #ifndef VRM_MANAGER_H
 #define VRM_MANAGER_H
 
-#include <map>
 #include <functional>
+#include <unordered_map>
 #include "../common/TriBFTDefs.h"
+#include "../common/NodeRegistry.h"
+#include "ReputationTable.h"
 
 namespace tribft {
 
@@ -16,6 +18,14 @@ namespace tribft {
  * - Provide reputation-based node selection
  * - Apply rewards and penalties based on actions
  * 
+ * Storage modes:
+ * - Private (default): each manager owns a full table of every node it
+ *   registered, i.e. O(N^2) records for N nodes running their own VRM.
+ * - Shared (useSharedStore): one process-wide table holds the
+ *   authoritative records (score, R_global, counters, history); each
+ *   manager keeps only an overlay of its local observations (R_local,
+ *   N_local) for nodes it actually interacted with.
+ * 
  * Design Principles:
  * - SOLID: Single responsibility for reputation management
  * - KISS: Simple reward/penalty system
@@ -34,10 +44,39 @@ public:
     // ========================================================================
     
     /**
-     * @brief Initialize the VRM manager
+     * @brief Initialize the VRM manager (current time becomes the decay epoch)
      */
     void initialize();
     
+    /**
+     * @brief Set decay tick interval in seconds (<= 0 disables decay)
+     * 
+     * Decay is applied lazily: a record catches up on the ticks it missed
+     * when it is read or updated, so no periodic timer is needed.
+     * Call right after initialize(), before registering nodes.
+     */
+    void setDecayInterval(double seconds);
+    
+    /**
+     * @brief Set lambda of the dynamic weight w = exp(-lambda * N_local)
+     * 
+     * Applies to the current table (shared by all managers in shared mode).
+     */
+    void setWeightLambda(double lambda);
+    
+    /**
+     * @brief Switch to the process-wide shared table (call right after initialize())
+     * 
+     * Records registered by any manager are visible to all; the decay
+     * clock starts at t=0 for the whole simulation, so every manager must
+     * use the same decay interval. Unregistering only drops this manager's
+     * local overlay. Table-wide queries (top nodes, statistics, level
+     * counts) reflect the shared view without local overlays.
+     */
+    void useSharedStore();
+    
+    bool isShared() const { return table_ != &ownTable_; }
+    
     /**
      * @brief Set logging callback
      */
@@ -72,9 +111,15 @@ public:
     ReputationScore getReputation(const NodeID& nodeID) const;
     
     /**
-     * @brief Get node's reputation record
+     * @brief Get snapshot of node's reputation record
+     * @return false if node is not registered
      */
-    const ReputationRecord* getRecord(const NodeID& nodeID) const;
+    bool getRecord(const NodeID& nodeID, ReputationRecord& record) const;
+    
+    /**
+     * @brief Number of penalized events for node in the last window seconds
+     */
+    int getRecentFailureCount(const NodeID& nodeID, simtime_t window) const;
     
     /**
      * @brief Check if node is reliable (reputation >= threshold)
@@ -82,12 +127,12 @@ public:
     bool isReliable(const NodeID& nodeID) const;
     
     /**
-     * @brief Get top N nodes by reputation
+     * @brief Get top N nodes by reputation (O(N) in the result size)
      */
     std::vector<NodeID> getTopNodes(int count) const;
     
     /**
-     * @brief Get average reputation of all nodes
+     * @brief Get average reputation of all nodes (O(1))
      */
     ReputationScore getAverageReputation() const;
     
@@ -135,12 +180,17 @@ public:
     // ========================================================================
     
     /**
-     * @brief Apply reputation decay (called periodically)
+     * @brief Bring every record up to date with pending decay ticks
+     * 
+     * Not needed for correctness (reads catch up on their own); useful
+     * before iterating over all records.
      */
     void applyDecay();
     
     /**
-     * @brief Clean up old events from history
+     * @brief Trim event history to the newest maxEventsPerNode entries
+     * 
+     * Optional: history never exceeds EventHistory::CAPACITY events.
      */
     void cleanupHistory(int maxEventsPerNode = 100);
     
@@ -148,12 +198,19 @@ public:
     // STATISTICS
     // ========================================================================
     
-    int getNodeCount() const { return records_.size(); }
+    int getNodeCount() const { return static_cast<int>(table_->size()); }
     int getReliableNodeCount() const;
     
+    /**
+     * @brief Number of nodes at a reputation level (O(1))
+     */
+    int getNodeCountAtLevel(ReputationTable::Level level) const;
+    
     struct Statistics {
         int totalNodes{0};
         int reliableNodes{0};
+        int standardNodes{0};
+        int candidateNodes{0};
         ReputationScore averageScore{0.0};
         ReputationScore maxScore{0.0};
         ReputationScore minScore{1.0};
@@ -168,9 +225,51 @@ private:
     
     /**
      * @brief Update reputation score
+     * 
+     * Score and R_global writes must go through table_->setScore() /
+     * setComponents(), and R_local / N_local through setLocalObservation(),
+     * so the rank index, level counts and local overlay stay current.
      */
     void updateScore(const NodeID& nodeID, double delta);
     
+    /**
+     * @brief Local observation of another node (overlay entry in shared mode)
+     */
+    struct LocalObservation {
+        ReputationScore performance{Constants::INITIAL_REPUTATION};  // R_local
+        int interactions{0};                                         // N_local
+    };
+    
+    /**
+     * @brief Final reputation as seen by this manager (shared record + local overlay)
+     */
+    double getFinalReputation(uint32_t slot) const;
+    
+    /**
+     * @brief Set R_local / N_local for slot (table columns or local overlay)
+     */
+    void setLocalObservation(uint32_t slot, ReputationScore performance, int interactions);
+    
+    /**
+     * @brief Process-wide table used by useSharedStore()
+     */
+    static ReputationTable& getSharedTable();
+    
+    /**
+     * @brief Find table slot by name (ReputationTable::NO_SLOT if not registered)
+     */
+    uint32_t findSlot(const NodeID& nodeID) const;
+    
+    /**
+     * @brief Find table slot and apply pending decay to it
+     */
+    uint32_t touchSlot(const NodeID& nodeID) const;
+    
+    /**
+     * @brief Decay tick and parameters at the current simulation time
+     */
+    ReputationTable::DecayStep getDecayStep() const;
+    
     /**
      * @brief Clamp reputation to valid range
      */
@@ -190,7 +289,11 @@ private:
     // PRIVATE DATA MEMBERS
     // ========================================================================
     
-    std::map<NodeID, ReputationRecord> records_;
+    mutable ReputationTable ownTable_;  // Private mode storage
+    ReputationTable* table_;            // ownTable_ or getSharedTable() (decayed on read)
+    std::unordered_map<NodeIndex, LocalObservation> localOverlay_;  // Shared mode only
+    double decayInterval_;              // Seconds between decay ticks (<= 0: off)
+    double decayEpoch_;                 // Time of tick 0
     LogCallback logCallback_;
 };
 
@@ -18,14 +18,19 @@ RegionalShardManager* RegionalShardManager::getGlobalInstance() {
 }
 
 RegionalShardManager::RegionalShardManager()
-    : nextShardID_(0)
+    : nodeCount_(0)
+    , spatialIndex_(Constants::REGIONAL_SHARD_RADIUS)
+    , nextShardID_(0)
     , shardRadius_(Constants::REGIONAL_SHARD_RADIUS)
     , minShardSize_(Constants::MIN_SHARD_SIZE)
     , maxShardSize_(Constants::MAX_SHARD_SIZE)
+    , incrementalHandoff_(false)
+    , handoffHysteresis_(0.0)
     , totalJoins_(0)
     , totalLeaves_(0)
     , totalSplits_(0)
     , totalMerges_(0)
+    , totalHandoffs_(0)
 {
 }
 
@@ -33,17 +38,34 @@ void RegionalShardManager::initialize(double shardRadius, int minShardSize, int
     shardRadius_ = shardRadius;
     minShardSize_ = minShardSize;
     maxShardSize_ = maxShardSize;
+    
+    // Grid cells are one shard radius wide; re-register any existing shards
+    spatialIndex_.reset(shardRadius_);
+    for (const auto& pair : shards_) {
+        spatialIndex_.insert(pair.first, pair.second.centerPoint, pair.second.radius);
+    }
+}
+
+void RegionalShardManager::setHandoffPolicy(bool incremental, double hysteresisMargin) {
+    incrementalHandoff_ = incremental;
+    handoffHysteresis_ = std::max(0.0, hysteresisMargin);
 }
 
 ShardID RegionalShardManager::addNode(const NodeID& nodeID, const GeoCoord& location, ReputationScore reputation) {
+    NodeIndex nodeIndex = NodeRegistry::getGlobalInstance().intern(nodeID);
+    if (nodeIndex >= nodes_.size()) {
+        nodes_.resize(nodeIndex + 1);
+    }
+    
     // Check if node already exists
-    if (nodeShardMap_.find(nodeID) != nodeShardMap_.end()) {
-        return nodeShardMap_[nodeID];
+    NodeEntry& entry = nodes_[nodeIndex];
+    if (entry.shardID != -1) {
+        return entry.shardID;
     }
     
     // Store node information
-    nodeLocationMap_[nodeID] = location;
-    nodeReputationMap_[nodeID] = reputation;
+    entry.location = location;
+    entry.reputation = reputation;
     
     // Find appropriate shard
     ShardID shardID = getShardForLocation(location);
@@ -55,9 +77,10 @@ ShardID RegionalShardManager::addNode(const NodeID& nodeID, const GeoCoord& loca
     
     // Add node to shard
     ShardInfo& shard = shards_[shardID];
-    shard.members.insert(nodeID);
+    shard.addMember(nodeIndex);
     shard.lastUpdate = simTime();
-    nodeShardMap_[nodeID] = shardID;
+    entry.shardID = shardID;
+    nodeCount_++;
     
     // Elect leader if needed
     if (shard.leader.empty()) {
@@ -74,34 +97,36 @@ ShardID RegionalShardManager::addNode(const NodeID& nodeID, const GeoCoord& loca
 }
 
 void RegionalShardManager::removeNode(const NodeID& nodeID) {
-    auto it = nodeShardMap_.find(nodeID);
-    if (it == nodeShardMap_.end()) {
+    removeNodeAt(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+void RegionalShardManager::removeNodeAt(NodeIndex nodeIndex) {
+    if (!findNode(nodeIndex)) {
         return; // Node not found
     }
     
-    ShardID shardID = it->second;
+    ShardID shardID = nodes_[nodeIndex].shardID;
     ShardInfo& shard = shards_[shardID];
     
     // Remove from shard
-    shard.members.erase(nodeID);
+    shard.removeMember(nodeIndex);
     shard.lastUpdate = simTime();
     
     // If removed node was leader, elect new leader
-    if (shard.leader == nodeID) {
+    if (shard.leader == NodeRegistry::getGlobalInstance().getName(nodeIndex)) {
         shard.leader.clear();
         if (!shard.members.empty()) {
             electLeader(shardID);
         }
     }
     
-    // Cleanup maps
-    nodeShardMap_.erase(nodeID);
-    nodeLocationMap_.erase(nodeID);
-    nodeReputationMap_.erase(nodeID);
+    // Cleanup node state
+    nodes_[nodeIndex] = NodeEntry();
+    nodeCount_--;
     
     // Check if shard should be merged or removed
     if (shard.members.empty()) {
-        shards_.erase(shardID);
+        eraseShard(shardID);
     } else if (shouldMergeShard(shardID)) {
         mergeShard(shardID);
     }
@@ -110,44 +135,61 @@ void RegionalShardManager::removeNode(const NodeID& nodeID) {
 }
 
 ShardID RegionalShardManager::updateNodeLocation(const NodeID& nodeID, const GeoCoord& newLocation) {
-    auto it = nodeShardMap_.find(nodeID);
-    if (it == nodeShardMap_.end()) {
+    return updateNodeLocation(NodeRegistry::getGlobalInstance().find(nodeID), newLocation);
+}
+
+ShardID RegionalShardManager::updateNodeLocation(NodeIndex nodeIndex, const GeoCoord& newLocation) {
+    if (!findNode(nodeIndex)) {
         return -1; // Node not found
     }
     
-    ShardID currentShardID = it->second;
-    nodeLocationMap_[nodeID] = newLocation;
+    NodeEntry& entry = nodes_[nodeIndex];
+    ShardID currentShardID = entry.shardID;
+    entry.location = newLocation;
     
-    // Check if node is still within current shard
+    // Check if node is still within current shard (plus hysteresis margin)
     const ShardInfo& currentShard = shards_[currentShardID];
-    if (currentShard.contains(newLocation)) {
+    if (currentShard.centerPoint.distanceTo(newLocation) <= currentShard.radius + handoffHysteresis_) {
         return currentShardID; // No change needed
     }
     
     // Node moved out of shard, reassign
-    removeNode(nodeID);
-    ReputationScore reputation = nodeReputationMap_[nodeID];
-    return addNode(nodeID, newLocation, reputation);
+    if (incrementalHandoff_) {
+        return handoffNode(nodeIndex, currentShardID, newLocation);
+    }
+    
+    ReputationScore reputation = entry.reputation;  // Read before removeNodeAt resets it
+    removeNodeAt(nodeIndex);
+    return addNode(NodeRegistry::getGlobalInstance().getName(nodeIndex), newLocation, reputation);
 }
 
 ShardID RegionalShardManager::getShardForLocation(const GeoCoord& location) const {
     ShardID bestShard = -1;
     double minDistance = std::numeric_limits<double>::max();
     
-    for (const auto& pair : shards_) {
-        ShardID shardID = pair.first;
-        const ShardInfo& shard = pair.second;
+    // Only shards overlapping the location's grid cell can contain it
+    for (ShardID shardID : spatialIndex_.candidatesAt(location)) {
+        auto it = shards_.find(shardID);
+        if (it == shards_.end()) {
+            continue;
+        }
+        const ShardInfo& shard = it->second;
         
         // Check if location is within shard radius
-        if (shard.contains(location)) {
-            // Check if shard can accept more members
-            if (canAcceptMember(shardID)) {
-                double distance = shard.centerPoint.distanceTo(location);
-                if (distance < minDistance) {
-                    minDistance = distance;
-                    bestShard = shardID;
-                }
-            }
+        double distance = shard.centerPoint.distanceTo(location);
+        if (distance > shard.radius) {
+            continue;
+        }
+        
+        // Check if shard can accept more members
+        if (shard.getMemberCount() >= static_cast<size_t>(maxShardSize_)) {
+            continue;
+        }
+        
+        // Prefer the closest center; ties go to the lowest shard ID
+        if (distance < minDistance || (distance == minDistance && shardID < bestShard)) {
+            minDistance = distance;
+            bestShard = shardID;
         }
     }
     
@@ -163,11 +205,12 @@ const ShardInfo* RegionalShardManager::getShardInfo(ShardID shardID) const {
 }
 
 ShardID RegionalShardManager::getNodeShard(const NodeID& nodeID) const {
-    auto it = nodeShardMap_.find(nodeID);
-    if (it != nodeShardMap_.end()) {
-        return it->second;
-    }
-    return -1;
+    return getNodeShard(NodeRegistry::getGlobalInstance().find(nodeID));
+}
+
+ShardID RegionalShardManager::getNodeShard(NodeIndex nodeIndex) const {
+    const NodeEntry* entry = findNode(nodeIndex);
+    return entry ? entry->shardID : -1;
 }
 
 std::vector<ShardInfo> RegionalShardManager::getAllShards() const {
@@ -207,9 +250,9 @@ void RegionalShardManager::electLeader(ShardID shardID) {
 }
 
 GeoCoord RegionalShardManager::getNodeLocation(const NodeID& nodeID) const {
-    auto it = nodeLocationMap_.find(nodeID);
-    if (it != nodeLocationMap_.end()) {
-        return it->second;
+    const NodeEntry* entry = findNode(NodeRegistry::getGlobalInstance().find(nodeID));
+    if (entry) {
+        return entry->location;
     }
     // Return default location if not found
     return GeoCoord{0.0, 0.0};
@@ -247,6 +290,13 @@ void RegionalShardManager::rebalanceShards() {
 // PRIVATE METHODS
 // ============================================================================
 
+const RegionalShardManager::NodeEntry* RegionalShardManager::findNode(NodeIndex nodeIndex) const {
+    if (nodeIndex < nodes_.size() && nodes_[nodeIndex].shardID != -1) {
+        return &nodes_[nodeIndex];
+    }
+    return nullptr;
+}
+
 ShardID RegionalShardManager::findNearestShard(const GeoCoord& location) const {
     ShardID nearestShard = -1;
     double minDistance = std::numeric_limits<double>::max();
@@ -273,9 +323,48 @@ ShardID RegionalShardManager::createShard(const GeoCoord& centerPoint) {
     shard.lastUpdate = simTime();
     
     shards_[shardID] = shard;
+    spatialIndex_.insert(shardID, shard.centerPoint, shard.radius);
     return shardID;
 }
 
+void RegionalShardManager::eraseShard(ShardID shardID) {
+    spatialIndex_.remove(shardID);
+    shards_.erase(shardID);
+}
+
+ShardID RegionalShardManager::handoffNode(NodeIndex nodeIndex, ShardID fromShardID, const GeoCoord& location) {
+    ShardID toShardID = getShardForLocation(location);
+    if (toShardID == fromShardID) {
+        return fromShardID;
+    }
+    if (toShardID == -1) {
+        toShardID = createShard(location);
+    }
+    
+    // Move the membership entry only
+    ShardInfo& fromShard = shards_[fromShardID];
+    ShardInfo& toShard = shards_[toShardID];
+    fromShard.removeMember(nodeIndex);
+    fromShard.lastUpdate = simTime();
+    toShard.addMember(nodeIndex);
+    toShard.lastUpdate = simTime();
+    nodes_[nodeIndex].shardID = toShardID;
+    
+    // Leader election only where the leader seat is affected
+    if (toShard.leader.empty()) {
+        electLeader(toShardID);
+    }
+    if (fromShard.members.empty()) {
+        eraseShard(fromShardID);
+    } else if (fromShard.leader == NodeRegistry::getGlobalInstance().getName(nodeIndex)) {
+        fromShard.leader.clear();
+        electLeader(fromShardID);
+    }
+    
+    totalHandoffs_++;
+    return toShardID;
+}
+
 bool RegionalShardManager::canAcceptMember(ShardID shardID) const {
     auto it = shards_.find(shardID);
     if (it != shards_.end()) {
@@ -323,25 +412,23 @@ void RegionalShardManager::splitShard(ShardID shardID) {
     ShardID newShardID = createShard(splitPoint);
     
     // Redistribute members based on proximity
-    std::vector<NodeID> membersToMove;
-    for (const NodeID& nodeID : originalShard.members) {
-        auto locIt = nodeLocationMap_.find(nodeID);
-        if (locIt != nodeLocationMap_.end()) {
-            double distToOriginal = originalShard.centerPoint.distanceTo(locIt->second);
-            double distToNew = splitPoint.distanceTo(locIt->second);
-            
-            if (distToNew < distToOriginal) {
-                membersToMove.push_back(nodeID);
-            }
+    std::vector<NodeIndex> membersToMove;
+    for (NodeIndex nodeIndex : originalShard.members) {
+        const GeoCoord& location = nodes_[nodeIndex].location;
+        double distToOriginal = originalShard.centerPoint.distanceTo(location);
+        double distToNew = splitPoint.distanceTo(location);
+        
+        if (distToNew < distToOriginal) {
+            membersToMove.push_back(nodeIndex);
         }
     }
     
     // Move members to new shard
     ShardInfo& newShard = shards_[newShardID];
-    for (const NodeID& nodeID : membersToMove) {
-        originalShard.members.erase(nodeID);
-        newShard.members.insert(nodeID);
-        nodeShardMap_[nodeID] = newShardID;
+    for (NodeIndex nodeIndex : membersToMove) {
+        originalShard.removeMember(nodeIndex);
+        newShard.addMember(nodeIndex);
+        nodes_[nodeIndex].shardID = newShardID;
     }
     
     // Elect leaders for both shards
@@ -365,13 +452,13 @@ void RegionalShardManager::mergeShard(ShardID shardID) {
     
     // Move all members to nearest shard
     ShardInfo& targetShard = shards_[nearestShard];
-    for (const NodeID& nodeID : it->second.members) {
-        targetShard.members.insert(nodeID);
-        nodeShardMap_[nodeID] = nearestShard;
+    for (NodeIndex nodeIndex : it->second.members) {
+        targetShard.addMember(nodeIndex);
+        nodes_[nodeIndex].shardID = nearestShard;
     }
     
     // Remove original shard
-    shards_.erase(shardID);
+    eraseShard(shardID);
     
     // Re-elect leader
     electLeader(nearestShard);
@@ -389,11 +476,11 @@ GeoCoord RegionalShardManager::calculateSplitPoint(const ShardInfo& shard) const
     double avgLon = 0.0;
     int count = 0;
     
-    for (const NodeID& nodeID : shard.members) {
-        auto it = nodeLocationMap_.find(nodeID);
-        if (it != nodeLocationMap_.end()) {
-            avgLat += it->second.latitude;
-            avgLon += it->second.longitude;
+    for (NodeIndex nodeIndex : shard.members) {
+        const NodeEntry* entry = findNode(nodeIndex);
+        if (entry) {
+            avgLat += entry->location.latitude;
+            avgLon += entry->location.longitude;
             count++;
         }
     }
@@ -423,17 +510,25 @@ ConsensusGroup RegionalShardManager::getCurrentConsensusGroup(ShardID shardID) c
 }
 
 bool RegionalShardManager::isInConsensusGroup(const NodeID& nodeID, ShardID shardID) const {
+    return isInConsensusGroup(NodeRegistry::getGlobalInstance().find(nodeID), shardID);
+}
+
+bool RegionalShardManager::isInConsensusGroup(NodeIndex nodeIndex, ShardID shardID) const {
     auto selectorIt = vrfSelectors_.find(shardID);
     if (selectorIt != vrfSelectors_.end()) {
-        return selectorIt->second->isInConsensusGroup(nodeID);
+        return selectorIt->second->isInConsensusGroup(nodeIndex);
     }
     return false;
 }
 
 NodeRole RegionalShardManager::getNodeRole(const NodeID& nodeID, ShardID shardID) const {
+    return getNodeRole(NodeRegistry::getGlobalInstance().find(nodeID), shardID);
+}
+
+NodeRole RegionalShardManager::getNodeRole(NodeIndex nodeIndex, ShardID shardID) const {
     auto selectorIt = vrfSelectors_.find(shardID);
     if (selectorIt != vrfSelectors_.end()) {
-        return selectorIt->second->getNodeRole(nodeID);
+        return selectorIt->second->getNodeRole(nodeIndex);
     }
     return NodeRole::ORDINARY;
 }
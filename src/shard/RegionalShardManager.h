@@ -6,7 +6,9 @@
 #include <vector>
 #include <algorithm>
 #include "../common/TriBFTDefs.h"
+#include "../common/NodeRegistry.h"
 #include "../consensus/VRFSelector.h"
+#include "ShardSpatialIndex.h"
 
 namespace tribft {
 
@@ -41,6 +43,13 @@ public:
      */
     void initialize(double shardRadius, int minShardSize, int maxShardSize);
     
+    /**
+     * @brief Configure how mobile nodes are handed between shards
+     * @param incremental Move only the membership entry instead of remove + add
+     * @param hysteresisMargin Extra distance (m) beyond the radius before a node leaves its shard
+     */
+    void setHandoffPolicy(bool incremental, double hysteresisMargin);
+    
     /**
      * @brief Add a node to appropriate shard based on location
      * @return Assigned shard ID
@@ -54,9 +63,15 @@ public:
     
     /**
      * @brief Update node's location (for mobile nodes)
+     * 
+     * A node keeps its shard until it is farther than radius + hysteresis
+     * margin from the shard center. In incremental mode only the membership
+     * entry moves; split/merge is left to rebalanceShards().
+     * 
      * @return New shard ID if changed, otherwise current shard ID
      */
     ShardID updateNodeLocation(const NodeID& nodeID, const GeoCoord& newLocation);
+    ShardID updateNodeLocation(NodeIndex nodeIndex, const GeoCoord& newLocation);
     
     /**
      * @brief Get shard ID for a given location
@@ -72,6 +87,7 @@ public:
      * @brief Get node's current shard
      */
     ShardID getNodeShard(const NodeID& nodeID) const;
+    ShardID getNodeShard(NodeIndex nodeIndex) const;
     
     /**
      * @brief Get all shards
@@ -117,11 +133,13 @@ public:
      * @brief Check if node is in consensus group
      */
     bool isInConsensusGroup(const NodeID& nodeID, ShardID shardID) const;
+    bool isInConsensusGroup(NodeIndex nodeIndex, ShardID shardID) const;
     
     /**
      * @brief Get node role
      */
     NodeRole getNodeRole(const NodeID& nodeID, ShardID shardID) const;
+    NodeRole getNodeRole(NodeIndex nodeIndex, ShardID shardID) const;
     
     /**
      * @brief Rebalance shards (merge small, split large)
@@ -132,7 +150,8 @@ public:
      * @brief Get statistics
      */
     int getShardCount() const { return shards_.size(); }
-    int getTotalNodes() const { return nodeShardMap_.size(); }
+    int getTotalNodes() const { return nodeCount_; }
+    int getTotalHandoffs() const { return totalHandoffs_; }
     
 private:
     // ========================================================================
@@ -149,6 +168,24 @@ private:
      */
     ShardID createShard(const GeoCoord& centerPoint);
     
+    /**
+     * @brief Remove a shard and its spatial index entry
+     */
+    void eraseShard(ShardID shardID);
+    
+    /**
+     * @brief Move a node's membership entry to the shard covering location
+     * 
+     * Re-elects a leader only for the shard that lost its leader or the
+     * shard that has none yet; no split/merge checks are performed.
+     */
+    ShardID handoffNode(NodeIndex nodeIndex, ShardID fromShardID, const GeoCoord& location);
+    
+    /**
+     * @brief Remove a registered node by index
+     */
+    void removeNodeAt(NodeIndex nodeIndex);
+    
     /**
      * @brief Check if shard can accept more members
      */
@@ -188,15 +225,31 @@ private:
     // PRIVATE DATA MEMBERS (Open-Closed Principle - protected data)
     // ========================================================================
     
+    /**
+     * @brief Per-node state (shard, location, reputation)
+     */
+    struct NodeEntry {
+        ShardID shardID = -1;                                // -1 = not registered
+        GeoCoord location;
+        ReputationScore reputation = Constants::INITIAL_REPUTATION;
+    };
+    
+    /**
+     * @brief Get registered node entry (nullptr if not registered)
+     */
+    const NodeEntry* findNode(NodeIndex nodeIndex) const;
+    
     std::map<ShardID, ShardInfo> shards_;                    // All shards
-    std::map<NodeID, ShardID> nodeShardMap_;                 // Node to shard mapping
-    std::map<NodeID, GeoCoord> nodeLocationMap_;             // Node locations
-    std::map<NodeID, ReputationScore> nodeReputationMap_;    // Node reputations
+    std::vector<NodeEntry> nodes_;                           // Node state, indexed by NodeIndex
+    int nodeCount_;                                          // Registered node count
+    ShardSpatialIndex spatialIndex_;                         // Grid over shard coverage
     
     ShardID nextShardID_;                                    // Next available shard ID
     double shardRadius_;                                     // Shard coverage radius
     int minShardSize_;                                       // Minimum nodes per shard
     int maxShardSize_;                                       // Maximum nodes per shard
+    bool incrementalHandoff_;                                // Move membership only on shard change
+    double handoffHysteresis_;                               // Margin beyond radius before leaving (m)
     
     // VRF selectors (one per shard)
     std::map<ShardID, VRFSelector*> vrfSelectors_;
@@ -207,6 +260,7 @@ private:
     int totalLeaves_;
     int totalSplits_;
     int totalMerges_;
+    int totalHandoffs_;
 };
 
 } // namespace tribft
@@ -0,0 +1,87 @@
+#include "ShardSpatialIndex.h"
+#include <algorithm>
+
+namespace tribft {
+
+namespace {
+    const std::vector<ShardID> kNoCandidates;
+}
+
+ShardSpatialIndex::ShardSpatialIndex(double cellSize)
+    : cellSize_(cellSize > 0.0 ? cellSize : Constants::REGIONAL_SHARD_RADIUS)
+{
+}
+
+void ShardSpatialIndex::reset(double cellSize) {
+    cellSize_ = cellSize > 0.0 ? cellSize : Constants::REGIONAL_SHARD_RADIUS;
+    cells_.clear();
+    extents_.clear();
+}
+
+void ShardSpatialIndex::insert(ShardID shardID, const GeoCoord& center, double radius) {
+    remove(shardID);
+
+    CellExtent extent;
+    extent.minX = toCell(center.latitude - radius);
+    extent.maxX = toCell(center.latitude + radius);
+    extent.minY = toCell(center.longitude - radius);
+    extent.maxY = toCell(center.longitude + radius);
+
+    for (int64_t x = extent.minX; x <= extent.maxX; ++x) {
+        for (int64_t y = extent.minY; y <= extent.maxY; ++y) {
+            cells_[makeKey(x, y)].push_back(shardID);
+        }
+    }
+
+    extents_[shardID] = extent;
+}
+
+void ShardSpatialIndex::remove(ShardID shardID) {
+    auto it = extents_.find(shardID);
+    if (it == extents_.end()) {
+        return;
+    }
+
+    const CellExtent& extent = it->second;
+    for (int64_t x = extent.minX; x <= extent.maxX; ++x) {
+        for (int64_t y = extent.minY; y <= extent.maxY; ++y) {
+            auto cellIt = cells_.find(makeKey(x, y));
+            if (cellIt == cells_.end()) {
+                continue;
+            }
+
+            // Keep remaining entries in insertion order (stable tie-breaking)
+            std::vector<ShardID>& shards = cellIt->second;
+            shards.erase(std::remove(shards.begin(), shards.end(), shardID), shards.end());
+            if (shards.empty()) {
+                cells_.erase(cellIt);
+            }
+        }
+    }
+
+    extents_.erase(it);
+}
+
+const std::vector<ShardID>& ShardSpatialIndex::candidatesAt(const GeoCoord& location) const {
+    auto it = cells_.find(makeKey(toCell(location.latitude), toCell(location.longitude)));
+    if (it != cells_.end()) {
+        return it->second;
+    }
+    return kNoCandidates;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+int64_t ShardSpatialIndex::toCell(double coordinate) const {
+    return static_cast<int64_t>(std::floor(coordinate / cellSize_));
+}
+
+ShardSpatialIndex::CellKey ShardSpatialIndex::makeKey(int64_t cellX, int64_t cellY) {
+    // Pack two signed 32-bit cell coordinates into one key
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(cellY));
+}
+
+} // namespace tribft
@@ -0,0 +1,74 @@
+#ifndef SHARD_SPATIAL_INDEX_H
+#define SHARD_SPATIAL_INDEX_H
+
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "../common/TriBFTDefs.h"
+
+namespace tribft {
+
+/**
+ * @brief Uniform-grid spatial index over shard coverage circles
+ *
+ * Each shard is registered in every grid cell touched by the bounding box
+ * of its coverage circle. Any shard that contains a location is therefore
+ * listed in the cell holding that location, so a lookup only has to test
+ * the handful of shards overlapping one cell instead of all shards.
+ *
+ * Design Principles:
+ * - KISS: Fixed cell size (one shard radius), hash map of occupied cells
+ * - SOLID: Pure geometry, no knowledge of membership or capacity
+ */
+class ShardSpatialIndex {
+public:
+    explicit ShardSpatialIndex(double cellSize = Constants::REGIONAL_SHARD_RADIUS);
+    ~ShardSpatialIndex() = default;
+
+    /**
+     * @brief Drop all entries and change the cell size
+     */
+    void reset(double cellSize);
+
+    /**
+     * @brief Register a shard's coverage circle
+     */
+    void insert(ShardID shardID, const GeoCoord& center, double radius);
+
+    /**
+     * @brief Unregister a shard (no-op if unknown)
+     */
+    void remove(ShardID shardID);
+
+    /**
+     * @brief Shards whose bounding box covers the cell containing location
+     * @return Candidate shard IDs in insertion order (superset of containing shards)
+     */
+    const std::vector<ShardID>& candidatesAt(const GeoCoord& location) const;
+
+    double getCellSize() const { return cellSize_; }
+    size_t getShardCount() const { return extents_.size(); }
+    size_t getCellCount() const { return cells_.size(); }
+
+private:
+    using CellKey = uint64_t;
+
+    /**
+     * @brief Inclusive range of cells covered by a shard
+     */
+    struct CellExtent {
+        int64_t minX, minY, maxX, maxY;
+    };
+
+    int64_t toCell(double coordinate) const;
+    static CellKey makeKey(int64_t cellX, int64_t cellY);
+
+    double cellSize_;
+    std::unordered_map<CellKey, std::vector<ShardID>> cells_;  // Cell -> overlapping shards
+    std::map<ShardID, CellExtent> extents_;                    // Shard -> covered cells
+};
+
+} // namespace tribft
+
+#endif // SHARD_SPATIAL_INDEX_H
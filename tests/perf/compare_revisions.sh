@@ -0,0 +1,56 @@
+#!/bin/sh
+#
+# Whole-simulation comparison of two revisions: wall time, event rate and
+# peak memory of one Cmdenv run each.
+#
+#   tests/perf/compare_revisions.sh <base-rev> [<rev> [<config>]]
+#
+# <rev> defaults to HEAD and <config> to NaningHighThroughput. Each
+# revision is checked out into a git worktree under $WORKDIR (default
+# /tmp/tribft-compare) and built there. VEINS_SRC must point to
+# veins/src, and veins_launchd must be running for the SUMO scenarios.
+# SIM_TIME_LIMIT (e.g. 120s) shortens the runs.
+#
+
+BASE=$1
+REV=${2:-HEAD}
+CONFIG=${3:-NaningHighThroughput}
+WORKDIR=${WORKDIR:-/tmp/tribft-compare}
+
+if [ -z "$BASE" ] || [ -z "$VEINS_SRC" ]; then
+    echo "usage: VEINS_SRC=/path/to/veins/src $0 <base-rev> [<rev> [<config>]]" >&2
+    exit 1
+fi
+
+REPO=$(git -C "$(dirname "$0")" rev-parse --show-toplevel) || exit 1
+EXTRA=
+if [ -n "$SIM_TIME_LIMIT" ]; then
+    EXTRA="--sim-time-limit=$SIM_TIME_LIMIT"
+fi
+
+run() {
+    NAME=$1
+    TREE=$WORKDIR/$NAME
+    rm -rf "$TREE"
+    git -C "$REPO" worktree add -f --detach "$TREE" "$2" >/dev/null || exit 1
+    (cd "$TREE" && make MODE=release >/dev/null) || exit 1
+
+    cd "$TREE/simulations/veins-base" || exit 1
+    /usr/bin/time -v opp_run -u Cmdenv -c "$CONFIG" -l "$TREE/tribft-omnet" -l "$VEINS_SRC/veins" \
+        -n "..:$TREE/src:$VEINS_SRC/veins" --cmdenv-express-mode=true \
+        --cmdenv-performance-display=true --result-dir="$WORKDIR/results-$NAME" $EXTRA \
+        omnetpp-tribft.ini >"$WORKDIR/$NAME.log" 2>"$WORKDIR/$NAME.time"
+    cd "$REPO" || exit 1
+
+    EVENTS=$(grep -o 'Event #[0-9]*' "$WORKDIR/$NAME.log" | tail -1 | tr -dc '0-9')
+    RATE=$(grep -o 'ev/sec=[0-9.e+]*' "$WORKDIR/$NAME.log" | tail -1 | cut -d= -f2)
+    WALL=$(grep 'Elapsed (wall clock)' "$WORKDIR/$NAME.time" | awk '{print $NF}')
+    RSS=$(grep 'Maximum resident set size' "$WORKDIR/$NAME.time" | awk '{print $NF}')
+    printf '%-6s %-12s events %-10s last ev/sec %-10s wall %-9s max RSS %s kB\n' \
+        "$NAME" "$(git -C "$REPO" rev-parse --short "$2")" "$EVENTS" "$RATE" "$WALL" "$RSS"
+}
+
+mkdir -p "$WORKDIR"
+run base "$BASE"
+run rev "$REV"
+git -C "$REPO" worktree prune